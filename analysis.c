@@ -0,0 +1,327 @@
+#include "analysis.h"
+#include "simulator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Marks every square reachable from square 1 (breadth-first search).
+ * Returns the number of reachable squares.
+ */
+static int mark_reachable(const Graph* graph, bool* reachable, int* queue) {
+    int head = 0, tail = 0;
+    reachable[1] = true;
+    queue[tail++] = 1;
+
+    while (head < tail) {
+        int square = queue[head++];
+        const int* neighbors = graph_neighbors(graph, square);
+        for (int j = 0; j < graph_degree(graph, square); j++) {
+            int next = neighbors[j];
+            if (!reachable[next]) {
+                reachable[next] = true;
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    return tail;
+}
+
+/**
+ * Marks every square from which the final square can be reached, by a
+ * breadth-first search over the reversed edges (stored as offsets + sources).
+ * Returns false on allocation failure, leaving can_finish[] incomplete.
+ */
+static bool mark_can_finish(const Graph* graph, int goal, bool* can_finish, int* queue) {
+    int n = graph->num_nodes;
+    int* offsets = calloc(n + 2, sizeof(int));
+    int* sources = malloc((size_t)(n + 1) * graph->die_faces * sizeof(int));
+    int* fill = calloc(n + 1, sizeof(int));
+    if (!offsets || !sources || !fill) {
+        free(offsets);
+        free(sources);
+        free(fill);
+        return false;
+    }
+
+    for (int i = 1; i <= n; i++) {
+        const int* neighbors = graph_neighbors(graph, i);
+        for (int j = 0; j < graph_degree(graph, i); j++) {
+            offsets[neighbors[j] + 1]++;
+        }
+    }
+    for (int i = 1; i <= n + 1; i++) {
+        offsets[i] += offsets[i - 1];
+    }
+    for (int i = 1; i <= n; i++) {
+        const int* neighbors = graph_neighbors(graph, i);
+        for (int j = 0; j < graph_degree(graph, i); j++) {
+            int target = neighbors[j];
+            sources[offsets[target] + fill[target]++] = i;
+        }
+    }
+
+    int head = 0, tail = 0;
+    can_finish[goal] = true;
+    queue[tail++] = goal;
+    while (head < tail) {
+        int square = queue[head++];
+        for (int k = offsets[square]; k < offsets[square + 1]; k++) {
+            int prev = sources[k];
+            if (!can_finish[prev]) {
+                can_finish[prev] = true;
+                queue[tail++] = prev;
+            }
+        }
+    }
+
+    free(offsets);
+    free(sources);
+    free(fill);
+    return true;
+}
+
+/**
+ * Tarjan's strongly connected components over the reachable squares,
+ * written iteratively so that large boards cannot overflow the call stack.
+ * Fills component[] (component id per square) and stores the count in
+ * *num_components. Returns false on allocation failure, leaving component[]
+ * unset.
+ */
+static bool find_components(const Graph* graph, const bool* reachable, int* component, int* num_components) {
+    int n = graph->num_nodes;
+    int* order = malloc((n + 1) * sizeof(int));     // Discovery index, 0 = unvisited
+    int* low = malloc((n + 1) * sizeof(int));
+    int* stack = malloc((n + 1) * sizeof(int));      // Tarjan stack
+    int* calls = malloc((n + 1) * sizeof(int));      // DFS call stack (squares)
+    int* edge = malloc((n + 1) * sizeof(int));       // Next edge to visit per square
+    bool* on_stack = calloc(n + 1, sizeof(bool));
+    if (!order || !low || !stack || !calls || !edge || !on_stack) {
+        free(order); free(low); free(stack); free(calls); free(edge); free(on_stack);
+        return false;
+    }
+
+    memset(order, 0, (n + 1) * sizeof(int));
+    int counter = 0, stack_top = 0, components = 0;
+
+    for (int root = 1; root <= n; root++) {
+        if (!reachable[root] || order[root]) continue;
+
+        int depth = 0;
+        calls[depth++] = root;
+        order[root] = low[root] = ++counter;
+        edge[root] = 0;
+        stack[stack_top++] = root;
+        on_stack[root] = true;
+
+        while (depth > 0) {
+            int square = calls[depth - 1];
+
+            if (edge[square] < graph_degree(graph, square)) {
+                int next = graph_neighbors(graph, square)[edge[square]++];
+                if (!order[next]) {
+                    order[next] = low[next] = ++counter;
+                    edge[next] = 0;
+                    stack[stack_top++] = next;
+                    on_stack[next] = true;
+                    calls[depth++] = next;
+                } else if (on_stack[next] && order[next] < low[square]) {
+                    low[square] = order[next];
+                }
+                continue;
+            }
+
+            // All edges done: close the component if this square is its root
+            if (low[square] == order[square]) {
+                int member;
+                do {
+                    member = stack[--stack_top];
+                    on_stack[member] = false;
+                    component[member] = components;
+                } while (member != square);
+                components++;
+            }
+
+            depth--;
+            if (depth > 0) {
+                int parent = calls[depth - 1];
+                if (low[square] < low[parent]) low[parent] = low[square];
+            }
+        }
+    }
+
+    free(order); free(low); free(stack); free(calls); free(edge); free(on_stack);
+    *num_components = components;
+    return true;
+}
+
+/**
+ * Propagates the position distribution for up to `max_steps` rolls and
+ * stores the probability mass absorbed by the final square in *won. Stops
+ * early once ANALYSIS_MAX_WORK transitions have been followed; `steps`
+ * receives the number of rolls actually covered. Returns false on allocation
+ * failure.
+ */
+static bool win_probability(const Graph* graph, int goal, const double* p, int max_steps,
+                            double* won, int* steps) {
+    int n = graph->num_nodes;
+    double* dist = calloc(n + 1, sizeof(double));
+    double* next = calloc(n + 1, sizeof(double));
+    if (!dist || !next) {
+        free(dist);
+        free(next);
+        return false;
+    }
+
+    long long work = 0;
+    dist[1] = 1.0;
+    *won = 0.0;
+    *steps = 0;
+
+    while (*steps < max_steps && work < ANALYSIS_MAX_WORK) {
+        memset(next, 0, (n + 1) * sizeof(double));
+        for (int s = 1; s <= n; s++) {
+            if (dist[s] == 0.0) continue;
+            const int* neighbors = graph_neighbors(graph, s);
+            for (int j = 0; j < graph_degree(graph, s); j++) {
+                next[neighbors[j]] += dist[s] * p[j];
+            }
+            work += graph_degree(graph, s) + 1;
+        }
+        (*steps)++;
+        *won += next[goal];
+        next[goal] = 0.0;
+
+        double* swap = dist;
+        dist = next;
+        next = swap;
+    }
+
+    free(dist);
+    free(next);
+    return true;
+}
+
+/**
+ * Runs the preflight analysis; see analysis.h for what is checked.
+ */
+bool graph_analyze(
+    const Graph* graph,
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    BoardAnalysis* out
+) {
+    if (!graph || !board || !out || graph->num_nodes != board->size || board->size < 1) return false;
+    if (die_faces <= 0 || die_faces != graph->die_faces) return false;
+    if (use_non_uniform && !dice_validate_probabilities(probabilities, die_faces)) return false;
+
+    int n = graph->num_nodes;
+    int goal = board->size;
+
+    bool* reachable = calloc(n + 1, sizeof(bool));
+    bool* can_finish = calloc(n + 1, sizeof(bool));
+    int* queue = malloc((n + 1) * sizeof(int));
+    int* component = malloc((n + 1) * sizeof(int));
+    bool* closed = NULL;
+    if (!reachable || !can_finish || !queue || !component) {
+        free(reachable); free(can_finish); free(queue); free(component);
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->num_reachable = mark_reachable(graph, reachable, queue);
+    out->goal_reachable = reachable[goal];
+
+    // On large boards these allocations can fail; a partial answer would mislabel squares
+    bool ok = mark_can_finish(graph, goal, can_finish, queue) &&
+              find_components(graph, reachable, component, &out->num_components);
+    if (ok) closed = calloc(out->num_components + 1, sizeof(bool));
+    if (!closed) {
+        free(reachable); free(can_finish); free(queue); free(component);
+        return false;
+    }
+
+    for (int s = 1; s <= n; s++) {
+        if (reachable[s] && !can_finish[s]) {
+            if (out->num_doomed < ANALYSIS_MAX_LISTED) out->doomed_squares[out->num_doomed] = s;
+            out->num_doomed++;
+        }
+    }
+
+    // A component is a trap if no edge leaves it and it does not hold the goal
+    for (int c = 0; c < out->num_components; c++) closed[c] = true;
+    for (int s = 1; s <= n; s++) {
+        if (!reachable[s]) continue;
+        const int* neighbors = graph_neighbors(graph, s);
+        for (int j = 0; j < graph_degree(graph, s); j++) {
+            if (component[neighbors[j]] != component[s]) {
+                closed[component[s]] = false;
+            }
+        }
+    }
+    for (int c = 0; c < out->num_components; c++) {
+        if (closed[c] && (!reachable[goal] || c != component[goal])) out->num_traps++;
+    }
+
+    double p[MAX_DIE_FACES];
+    double total_weight = 0.0;
+    for (int r = 0; r < die_faces; r++) {
+        p[r] = use_non_uniform ? probabilities[r] : 1.0;
+        total_weight += p[r];
+    }
+    for (int r = 0; r < die_faces; r++) {
+        p[r] /= total_weight;
+    }
+    int move_cap = simulate_move_cap(board);
+    if (out->goal_reachable) {
+        ok = win_probability(graph, goal, p, move_cap, &out->win_probability, &out->horizon);
+    }
+    free(reachable); free(can_finish); free(queue); free(component); free(closed);
+    if (!ok) return false;
+    out->horizon_complete = out->horizon >= move_cap;
+
+    // A propagation cut short says nothing about games near the move cap
+    bool too_slow = out->horizon_complete && out->win_probability < ANALYSIS_WARN_WIN_PROBABILITY;
+    if (!out->goal_reachable ||
+        (out->horizon_complete && out->win_probability < ANALYSIS_MIN_WIN_PROBABILITY)) {
+        out->health = BOARD_BROKEN;
+    } else if (out->num_doomed > 0 || out->num_traps > 0 || too_slow) {
+        out->health = BOARD_WARNING;
+    } else {
+        out->health = BOARD_OK;
+    }
+    return true;
+}
+
+/**
+ * Prints the problems found by graph_analyze(), listing offending squares.
+ */
+void analysis_print(const BoardAnalysis* analysis) {
+    if (!analysis || analysis->health == BOARD_OK) return;
+
+    const char* icon = (analysis->health == BOARD_BROKEN) ? "❌" : "⚠️";
+
+    if (!analysis->goal_reachable) {
+        fprintf(stderr, "%s Final square is unreachable from square 1 (%d squares reachable)\n",
+                icon, analysis->num_reachable);
+    }
+
+    if (analysis->num_doomed > 0) {
+        fprintf(stderr, "%s %d trap(s): the final square cannot be reached from %d square(s):",
+                icon, analysis->num_traps, analysis->num_doomed);
+        for (int i = 0; i < analysis->num_doomed && i < ANALYSIS_MAX_LISTED; i++) {
+            fprintf(stderr, " %d", analysis->doomed_squares[i]);
+        }
+        if (analysis->num_doomed > ANALYSIS_MAX_LISTED) fprintf(stderr, " ...");
+        fprintf(stderr, "\n");
+    }
+
+    if (analysis->goal_reachable && analysis->horizon_complete &&
+        analysis->win_probability < ANALYSIS_WARN_WIN_PROBABILITY) {
+        fprintf(stderr, "%s Only %.4g%% of games are won within %d moves\n",
+                icon, analysis->win_probability * 100.0, analysis->horizon);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "board.h"
+#include "graph.h"
+#include <stdbool.h>
+
+#define ANALYSIS_MIN_WIN_PROBABILITY  1e-3  // Below this the board is considered broken
+#define ANALYSIS_WARN_WIN_PROBABILITY 0.99  // Below this a warning is issued
+#define ANALYSIS_MAX_LISTED           20    // Offending squares kept and printed
+#define ANALYSIS_MAX_WORK             200000000  // Transitions followed when propagating win_probability
+
+/**
+ * Overall verdict of the preflight analysis.
+ */
+typedef enum {
+    BOARD_OK,       // Board can be simulated as is
+    BOARD_WARNING,  // Traps or many games hitting the move cap
+    BOARD_BROKEN    // Final square unreachable or (almost) never reached
+} BoardHealth;
+
+/**
+ * Result of analysing a board graph before simulating it.
+ */
+typedef struct {
+    BoardHealth health;
+    bool goal_reachable;                  // Final square reachable from square 1
+    int num_reachable;                    // Squares reachable from square 1
+    int num_components;                   // Strongly connected components among reachable squares
+    int doomed_squares[ANALYSIS_MAX_LISTED]; // First reachable squares from which the final square is unreachable
+    int num_doomed;                       // Total number of such squares (may exceed the list)
+    int num_traps;                        // Closed components (no way out) that do not hold the final square
+    double win_probability;               // P(win within `horizon` rolls)
+    int horizon;                          // Rolls covered by win_probability
+    bool horizon_complete;                // horizon reached the move cap of the board
+} BoardAnalysis;
+
+/**
+ * Analyses the board graph built by graph_build():
+ * - reachability of the final square from square 1,
+ * - strongly connected components of the squares reachable from square 1,
+ * - traps: closed components from which the final square cannot be reached,
+ * - the probability that a game is won within the move cap
+ *   (simulate_move_cap()) of the board.
+ *
+ * The probability is found by propagating the position distribution roll by
+ * roll, stopping after ANALYSIS_MAX_WORK transitions. On large boards this
+ * may end before the move cap; the verdict then rests on reachability and
+ * traps alone.
+ *
+ * @param graph Graph built with graph_build() for the same board and die.
+ * @param board Pointer to the board.
+ * @param die_faces Number of die faces used to build the graph.
+ * @param use_non_uniform Use weighted die if true.
+ * @param probabilities Weights for non-uniform die (if enabled).
+ * @param out Output structure for the analysis.
+ * @return true if the analysis ran, false on invalid parameters or allocation failure.
+ */
+bool graph_analyze(
+    const Graph* graph,
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    BoardAnalysis* out
+);
+
+/**
+ * Prints the findings of the analysis (warnings and offending squares) to stderr.
+ * Prints nothing for a healthy board.
+ *
+ * @param analysis Pointer to the analysis result.
+ */
+void analysis_print(const BoardAnalysis* analysis);
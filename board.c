@@ -1,20 +1,71 @@
 #include "board.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BOARD_INITIAL_JUMPS 16  // Initial capacity of the snake and ladder arrays
 
 /**
  * Initializes the board with given width and height.
- * Resets snake and ladder counters to zero.
+ * Resets snake and ladder counters to zero and selects the classic rules.
+ * Allocates the per-square lookup tables.
  */
-void board_init(Board* board, int width, int height) {
-    if (!board || width <= 0 || height <= 0 || width * height > MAX_BOARD_SIZE) {
-        return; // Invalid parameters or board too large
+bool board_init(Board* board, int width, int height) {
+    if (!board || width <= 0 || height <= 0 ||
+        width > MAX_BOARD_WIDTH || height > MAX_BOARD_HEIGHT) {
+        return false; // Invalid parameters or board too large
     }
 
+    memset(board, 0, sizeof(*board));
     board->width = width;
     board->height = height;
     board->size = width * height;
-    board->num_snakes = 0;
-    board->num_ladders = 0;
+    board->rules = 0;
+
+    board->jump_dest = calloc((size_t)board->size + 1, sizeof(int));
+    board->jump_slot = calloc((size_t)board->size + 1, sizeof(int));
+    if (!board->jump_dest || !board->jump_slot) {
+        board_free(board);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Frees the jump arrays and lookup tables and zeroes the board.
+ */
+void board_free(Board* board) {
+    if (!board) return;
+
+    free(board->snakes);
+    free(board->ladders);
+    free(board->jump_dest);
+    free(board->jump_slot);
+    memset(board, 0, sizeof(*board));
+}
+
+/**
+ * Makes room for one more jump in an array, doubling its capacity if needed.
+ */
+static bool reserve_jump(Jump** jumps, int count, int* capacity) {
+    if (count < *capacity) return true;
+
+    int grown_capacity = *capacity ? *capacity * 2 : BOARD_INITIAL_JUMPS;
+    Jump* grown = realloc(*jumps, (size_t)grown_capacity * sizeof(Jump));
+    if (!grown) return false;
+
+    *jumps = grown;
+    *capacity = grown_capacity;
+    return true;
+}
+
+/**
+ * Records a new jump in the per-square lookup tables.
+ */
+static void mark_jump(Board* board, int start, int end, int slot) {
+    board->jump_dest[start] = end;
+    board->jump_slot[start] = slot;
+    board->jump_dest[end] = -1;
 }
 
 /**
@@ -22,15 +73,17 @@ void board_init(Board* board, int width, int height) {
  * Validates input and checks for conflict with existing snakes/ladders.
  */
 bool board_add_snake(Board* board, int start, int end) {
-    if (!board || board->num_snakes >= MAX_SNAKES) return false;
+    if (!board || !board->jump_dest) return false;
 
     // Snake must go downward and not end on same square or outside bounds
     if (start <= end || start >= board->size || end < 1 || start == board->size) return false;
 
     if (board_is_conflict(board, start, end)) return false;
+    if (!reserve_jump(&board->snakes, board->num_snakes, &board->snake_capacity)) return false;
 
     board->snakes[board->num_snakes].start = start;
     board->snakes[board->num_snakes].end = end;
+    mark_jump(board, start, end, board->num_snakes);
     board->num_snakes++;
     return true;
 }
@@ -40,15 +93,17 @@ bool board_add_snake(Board* board, int start, int end) {
  * Validates input and checks for conflict with existing snakes/ladders.
  */
 bool board_add_ladder(Board* board, int start, int end) {
-    if (!board || board->num_ladders >= MAX_LADDERS) return false;
+    if (!board || !board->jump_dest) return false;
 
     // Ladder must go upward and not exceed board size
     if (start >= end || end > board->size || start < 1 || start == board->size) return false;
 
     if (board_is_conflict(board, start, end)) return false;
+    if (!reserve_jump(&board->ladders, board->num_ladders, &board->ladder_capacity)) return false;
 
     board->ladders[board->num_ladders].start = start;
     board->ladders[board->num_ladders].end = end;
+    mark_jump(board, start, end, board->num_ladders);
     board->num_ladders++;
     return true;
 }
@@ -58,23 +113,10 @@ bool board_add_ladder(Board* board, int start, int end) {
  * Returns the destination square after applying the jump.
  */
 int board_apply_jump(const Board* board, int position) {
-    if (!board) return position;
-
-    // Check if position is the start of a ladder
-    for (int i = 0; i < board->num_ladders; i++) {
-        if (board->ladders[i].start == position) {
-            return board->ladders[i].end;
-        }
-    }
+    if (!board || position < 1 || position > board->size) return position;
 
-    // Check if position is the start of a snake
-    for (int i = 0; i < board->num_snakes; i++) {
-        if (board->snakes[i].start == position) {
-            return board->snakes[i].end;
-        }
-    }
-
-    return position; // No jump
+    int dest = board->jump_dest[position];
+    return (dest > 0) ? dest : position; // No jump starts here
 }
 
 /**
@@ -82,39 +124,35 @@ int board_apply_jump(const Board* board, int position) {
  * Returns true if the start or end overlaps with any other object.
  */
 bool board_is_conflict(const Board* board, int start, int end) {
-    for (int i = 0; i < board->num_snakes; i++) {
-        if (board->snakes[i].start == start || board->snakes[i].end == end ||
-            board->snakes[i].start == end || board->snakes[i].end == start) {
-            return true;
-        }
-    }
+    if (!board || !board->jump_dest) return true;
+    if (start < 1 || start > board->size || end < 1 || end > board->size) return true;
 
-    for (int i = 0; i < board->num_ladders; i++) {
-        if (board->ladders[i].start == start || board->ladders[i].end == end ||
-            board->ladders[i].start == end || board->ladders[i].end == start) {
-            return true;
-        }
-    }
-
-    return false;
+    return board->jump_dest[start] != 0 || board->jump_dest[end] != 0;
 }
 
 /**
  * Prints the board configuration including ladders and snakes.
- * Useful for debugging and verification.
+ * Useful for debugging and verification. Long lists are cut short.
  */
 void board_print(const Board* board) {
     if (!board) return;
 
     printf("Board Size: %dx%d (%d squares)\n", board->width, board->height, board->size);
+    rules_print(board->rules);
 
     printf("Ladders (%d):\n", board->num_ladders);
-    for (int i = 0; i < board->num_ladders; i++) {
+    for (int i = 0; i < board->num_ladders && i < BOARD_PRINT_LIMIT; i++) {
         printf("  Ladder from %d to %d\n", board->ladders[i].start, board->ladders[i].end);
     }
+    if (board->num_ladders > BOARD_PRINT_LIMIT) {
+        printf("  ... (%d more)\n", board->num_ladders - BOARD_PRINT_LIMIT);
+    }
 
     printf("Snakes (%d):\n", board->num_snakes);
-    for (int i = 0; i < board->num_snakes; i++) {
+    for (int i = 0; i < board->num_snakes && i < BOARD_PRINT_LIMIT; i++) {
         printf("  Snake from %d to %d\n", board->snakes[i].start, board->snakes[i].end);
     }
+    if (board->num_snakes > BOARD_PRINT_LIMIT) {
+        printf("  ... (%d more)\n", board->num_snakes - BOARD_PRINT_LIMIT);
+    }
 }
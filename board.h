@@ -1,12 +1,13 @@
 #pragma once
 
+#include "rules.h"
 #include <stdbool.h>
 
-#define MAX_BOARD_WIDTH  10
-#define MAX_BOARD_HEIGHT 10
+#define MAX_BOARD_WIDTH  2000
+#define MAX_BOARD_HEIGHT 2000
 #define MAX_BOARD_SIZE   (MAX_BOARD_WIDTH * MAX_BOARD_HEIGHT)
-#define MAX_SNAKES       50
-#define MAX_LADDERS      50
+
+#define BOARD_PRINT_LIMIT 50  // Snakes / ladders listed by board_print() and stats_print()
 
 /// Represents either a snake or a ladder on the board.
 typedef struct {
@@ -15,25 +16,45 @@ typedef struct {
 } Jump;
 
 /// Represents the full board with its snakes and ladders.
+/// Arrays are allocated by board_init() and released by board_free().
 typedef struct {
     int width;   // e.g., 10 for a 10x10 board
     int height;  // e.g., 10 for a 10x10 board
     int size;    // width * height
 
-    Jump snakes[MAX_SNAKES];
+    Jump* snakes;
     int num_snakes;
+    int snake_capacity;
 
-    Jump ladders[MAX_LADDERS];
+    Jump* ladders;
     int num_ladders;
+    int ladder_capacity;
+
+    // Per-square lookup tables (index 1..size), so that jumps and conflicts
+    // are found in O(1) instead of by scanning every snake and ladder.
+    int* jump_dest;   // Destination if a jump starts here, -1 if one ends here, 0 otherwise
+    int* jump_slot;   // Index into snakes[] or ladders[] of the jump starting here
+
+    RuleSet rules;  // Rule variant (0 = classic rules), see rules.h
 } Board;
 
 /**
- * Initializes the board with given dimensions.
+ * Initializes the board with given dimensions and the classic rules.
+ * The board must not hold allocations from an earlier board_init()
+ * (call board_free() first).
  * @param board Pointer to the board to initialize.
  * @param width Width of the board (e.g., 10).
  * @param height Height of the board (e.g., 10).
+ * @return true on success, false on invalid dimensions or allocation failure.
+ */
+bool board_init(Board* board, int width, int height);
+
+/**
+ * Releases the memory held by a board and resets it to an empty state.
+ * Safe to call on a zeroed or already freed board.
+ * @param board Pointer to the board.
  */
-void board_init(Board* board, int width, int height);
+void board_free(Board* board);
 
 /**
  * Adds a snake to the board.
@@ -64,7 +85,9 @@ bool board_add_ladder(Board* board, int start, int end);
 int board_apply_jump(const Board* board, int position);
 
 /**
- * Checks whether a jump overlaps with any existing snake or ladder.
+ * Checks whether a jump overlaps with any existing snake or ladder,
+ * i.e. whether its start or end square is already the start or end of one.
+ * Runs in constant time.
  * @param board Pointer to the board.
  * @param start Proposed start square.
  * @param end Proposed end square.
@@ -73,7 +96,8 @@ int board_apply_jump(const Board* board, int position);
 bool board_is_conflict(const Board* board, int start, int end);
 
 /**
- * Prints the current board configuration (for debugging).
+ * Prints the current board configuration (for debugging), listing at most
+ * BOARD_PRINT_LIMIT snakes and ladders.
  * @param board Pointer to the board.
  */
 void board_print(const Board* board);
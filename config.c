@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200809L  // for fmemopen()
+
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
@@ -9,6 +11,7 @@
  *   BOARD <width> <height>
  *   LADDER <start> <end>
  *   SNAKE <start> <end>
+ *   RULE <name>            (see rules_add(), may appear several times)
  * Lines starting with '#' or empty lines are ignored.
  *
  * @param board Pointer to the board to initialize and populate.
@@ -24,45 +27,102 @@ bool load_board_from_file(Board* board, const char* filename) {
         return false;
     }
 
+    bool loaded = load_board_from_stream(board, file);
+    fclose(file);
+    return loaded;
+}
+
+/**
+ * Loads a board configuration from an in-memory copy of a config file,
+ * e.g. contents that were already read for hashing.
+ */
+bool load_board_from_buffer(Board* board, const char* data, size_t length) {
+    if (!board || !data || length == 0) return false;
+
+    FILE* stream = fmemopen((void*)data, length, "r");
+    if (!stream) {
+        perror("Failed to open board configuration buffer");
+        return false;
+    }
+
+    bool loaded = load_board_from_stream(board, stream);
+    fclose(stream);
+    return loaded;
+}
+
+/**
+ * Parses board configuration lines from an open stream until end of file.
+ * The stream is not closed. Each line is handled in constant time, so
+ * loading is linear in the number of lines.
+ */
+bool load_board_from_stream(Board* board, FILE* file) {
+    if (!board || !file) return false;
+
     char line[256];                   // Buffer for reading each line
     int width = 10, height = 10;      // Default board size (in case BOARD line is missing)
     bool board_initialized = false;   // Flag to prevent early use before init
+    bool failed = false;
+
+    memset(board, 0, sizeof(*board)); // Nothing allocated yet
 
     // Read the file line by line
-    while (fgets(line, sizeof(line), file)) {
+    while (!failed && fgets(line, sizeof(line), file)) {
         char temp[16];
 
         // Skip comments and blank lines
-        if (line[0] == '#' || sscanf(line, "%15s", temp) == 0)
+        if (line[0] == '#' || sscanf(line, "%15s", temp) != 1)
             continue;
 
         int start, end;
+        char rule[32];
 
         // Check for board size definition
         if (sscanf(line, "BOARD %d %d", &width, &height) == 2) {
-            board_init(board, width, height);
-            board_initialized = true;
+            board_free(board); // A later BOARD line starts over
+            board_initialized = board_init(board, width, height);
+            if (!board_initialized) {
+                fprintf(stderr, "⚠️ Invalid board size %dx%d\n", width, height);
+                failed = true;
+            }
+            continue;
+        }
+
+        // Every other line needs a board (default size if BOARD is missing)
+        if (!board_initialized) {
+            board_initialized = board_init(board, width, height);
+            if (!board_initialized) {
+                failed = true;
+                continue;
+            }
+        }
 
         // Check for ladder definition
-        } else if (sscanf(line, "LADDER %d %d", &start, &end) == 2) {
-            if (!board_initialized) board_init(board, width, height);
+        if (sscanf(line, "LADDER %d %d", &start, &end) == 2) {
             if (!board_add_ladder(board, start, end)) {
                 fprintf(stderr, "⚠️ Invalid ladder from %d to %d\n", start, end);
             }
 
         // Check for snake definition
         } else if (sscanf(line, "SNAKE %d %d", &start, &end) == 2) {
-            if (!board_initialized) board_init(board, width, height);
             if (!board_add_snake(board, start, end)) {
                 fprintf(stderr, "⚠️ Invalid snake from %d to %d\n", start, end);
             }
 
+        // Check for rule variant
+        } else if (sscanf(line, "RULE %31s", rule) == 1) {
+            if (!rules_add(&board->rules, rule)) {
+                fprintf(stderr, "⚠️ Invalid or conflicting rule: %s\n", rule);
+            }
+
         // Unknown line format
         } else {
             fprintf(stderr, "⚠️ Unknown line format: %s", line);
         }
     }
 
-    fclose(file);
-    return board_initialized;
+    if (failed || !board_initialized) {
+        board_free(board);
+        return false;
+    }
+    return true;
 }
@@ -2,12 +2,37 @@
 
 #include "board.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 /**
  * Loads a board configuration from a text file.
+ * On success the board owns allocations; release them with board_free().
+ * On failure nothing is left allocated.
  *
  * @param board Pointer to the board to initialize and fill.
  * @param filename Path to the configuration file (e.g., "board1.cfg").
  * @return true if the file was successfully loaded, false otherwise.
  */
 bool load_board_from_file(Board* board, const char* filename);
+
+/**
+ * Loads a board configuration from a memory buffer holding the contents
+ * of a configuration file (same format as load_board_from_file()).
+ *
+ * @param board Pointer to the board to initialize and fill.
+ * @param data Configuration text (need not be NUL-terminated).
+ * @param length Number of bytes in `data`.
+ * @return true if the board was successfully loaded, false otherwise.
+ */
+bool load_board_from_buffer(Board* board, const char* data, size_t length);
+
+/**
+ * Loads a board configuration from an already opened stream.
+ * Reads until end of file; the caller keeps ownership of the stream.
+ *
+ * @param board Pointer to the board to initialize and fill.
+ * @param file Stream positioned at the start of the configuration.
+ * @return true if the board was successfully loaded, false otherwise.
+ */
+bool load_board_from_stream(Board* board, FILE* file);
@@ -1,5 +1,9 @@
 #include "dice.h"
 #include <stdio.h>
+#include <limits.h>
+
+// Generator behind the legacy single-threaded API (dice_roll_uniform etc.)
+static DiceRng default_rng = { 0x9E3779B97F4A7C15ULL };
 
 /**
  * Initializes the random number generator.
@@ -7,7 +11,14 @@
  */
 void dice_init(void) {
     // Seed the random number generator using current time
-    srand((unsigned int)time(NULL));
+    dice_rng_seed(&default_rng, (uint64_t)time(NULL));
+}
+
+/**
+ * Returns the process-wide generator used by the legacy dice functions.
+ */
+DiceRng* dice_default_rng(void) {
+    return &default_rng;
 }
 
 /**
@@ -16,12 +27,7 @@ void dice_init(void) {
  * If `faces` is invalid, returns 1 and prints a warning.
  */
 int dice_roll_uniform(int faces) {
-    if (faces <= 0 || faces > MAX_DIE_FACES) {
-        fprintf(stderr, "Invalid number of die faces: %d\n", faces);
-        return 1;
-    }
-
-    return (rand() % faces) + 1;
+    return dice_rng_roll_uniform(&default_rng, faces);
 }
 
 /**
@@ -32,47 +38,106 @@ int dice_roll_uniform(int faces) {
  * @return A random die face (1-based index) according to the weighted distribution
  */
 int dice_roll_non_uniform(int faces, const int* probabilities) {
+    return dice_rng_roll_non_uniform(&default_rng, faces, probabilities);
+}
+
+/**
+ * Validates the given probability array for a non-uniform die.
+ * Returns true if all values are positive and their sum fits an int.
+ */
+bool dice_validate_probabilities(const int* probabilities, int faces) {
     if (!probabilities || faces <= 0 || faces > MAX_DIE_FACES) {
-        return dice_roll_uniform(faces); // fallback to fair roll
+        return false;
     }
 
-    // Calculate total weight from the probability array
-    int total = 0;
+    int64_t total = 0;
     for (int i = 0; i < faces; i++) {
-        if (probabilities[i] <= 0) return dice_roll_uniform(faces); // invalid weight
+        if (probabilities[i] <= 0) {
+            return false; // All weights must be strictly positive
+        }
         total += probabilities[i];
     }
 
-    // Generate random number between 1 and total weight
-    int r = (rand() % total) + 1;
+    return total <= INT_MAX; // Rolls draw from [1, total] in int arithmetic
+}
 
-    // Find which face corresponds to the random weight
-    int cumulative = 0;
-    for (int i = 0; i < faces; i++) {
-        cumulative += probabilities[i];
-        if (r <= cumulative) {
-            return i + 1; // faces are 1-based
-        }
+/**
+ * Scrambles the seed with one SplitMix64 step so that close seeds
+ * (e.g. consecutive worker indices) give unrelated streams.
+ */
+void dice_rng_seed(DiceRng* rng, uint64_t seed) {
+    if (!rng) return;
+
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    rng->state = z ? z : 0x9E3779B97F4A7C15ULL; // xorshift state must be non-zero
+}
+
+/**
+ * Advances the xorshift64* generator and returns the next 64-bit output.
+ */
+static uint64_t dice_rng_next(DiceRng* rng) {
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Returns a uniform double in (0, 1) built from the top 53 output bits.
+ */
+double dice_rng_unit(DiceRng* rng) {
+    // Shifted by half a step so the result is never exactly 0 or 1
+    return ((double)(dice_rng_next(rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Rolls a fair die using the caller's generator.
+ * Uses a multiply-shift reduction instead of modulo (no division per roll).
+ */
+int dice_rng_roll_uniform(DiceRng* rng, int faces) {
+    if (!rng) return 1;
+    if (faces <= 0 || faces > MAX_DIE_FACES) {
+        fprintf(stderr, "Invalid number of die faces: %d\n", faces);
+        return 1;
     }
 
-    // Fallback (should not happen if probabilities are valid)
-    return faces;
+    uint32_t r = (uint32_t)(dice_rng_next(rng) >> 32);
+    return (int)(((uint64_t)r * (uint32_t)faces) >> 32) + 1;
 }
 
 /**
- * Validates the given probability array for a non-uniform die.
- * Returns true if all values are positive and within bounds.
+ * Rolls a non-uniform die using the caller's generator.
+ * Same weighting rules and fallbacks as dice_roll_non_uniform().
  */
-bool dice_validate_probabilities(const int* probabilities, int faces) {
+int dice_rng_roll_non_uniform(DiceRng* rng, int faces, const int* probabilities) {
     if (!probabilities || faces <= 0 || faces > MAX_DIE_FACES) {
-        return false;
+        return dice_rng_roll_uniform(rng, faces); // fallback to fair roll
     }
 
+    int64_t sum = 0;
     for (int i = 0; i < faces; i++) {
-        if (probabilities[i] <= 0) {
-            return false; // All weights must be strictly positive
+        if (probabilities[i] <= 0) return dice_rng_roll_uniform(rng, faces); // invalid weight
+        sum += probabilities[i];
+    }
+    if (sum > INT_MAX) return dice_rng_roll_uniform(rng, faces); // weights too large
+    int total = (int)sum;
+
+    uint32_t bits = (uint32_t)(dice_rng_next(rng) >> 32);
+    int r = (int)(((uint64_t)bits * (uint32_t)total) >> 32) + 1;
+
+    int cumulative = 0;
+    for (int i = 0; i < faces; i++) {
+        cumulative += probabilities[i];
+        if (r <= cumulative) {
+            return i + 1;
         }
     }
 
-    return true;
+    return faces;
 }
@@ -1,17 +1,32 @@
 #pragma once
 
-#include <stdlib.h>  // for rand()
+#include <stdlib.h>
 #include <time.h>    // for seeding
 #include <stdbool.h>
+#include <stdint.h>
 
 #define MAX_DIE_FACES 20  
 
+/**
+ * State of an independent random number generator (xorshift64*).
+ * Each thread that rolls dice should own one, so that no state is shared.
+ */
+typedef struct {
+    uint64_t state;
+} DiceRng;
+
 /**
  * Initializes the random number generator.
  * Call once at program startup.
  */
 void dice_init(void);
 
+/**
+ * Returns the process-wide generator behind dice_roll_uniform() and
+ * dice_roll_non_uniform(). Not thread-safe: threads should own a DiceRng.
+ */
+DiceRng* dice_default_rng(void);
+
 /**
  * Rolls a fair die with the given number of faces.
  * @param faces Number of die faces (e.g., 6).
@@ -28,11 +43,44 @@ int dice_roll_uniform(int faces);
  */
 int dice_roll_non_uniform(int faces, const int* probabilities);
 
+/**
+ * Seeds an independent random number generator.
+ * Different seeds give independent-looking streams, including seeds that
+ * differ in a single bit (the seed is scrambled before use).
+ * @param rng Generator to seed.
+ * @param seed Any 64-bit value.
+ */
+void dice_rng_seed(DiceRng* rng, uint64_t seed);
+
+/**
+ * Returns a uniformly distributed number in (0, 1) from the given generator.
+ * @param rng Generator to draw from.
+ */
+double dice_rng_unit(DiceRng* rng);
+
+/**
+ * Rolls a fair die using the given generator.
+ * @param rng Generator to draw from.
+ * @param faces Number of die faces (e.g., 6).
+ * @return A value between 1 and faces.
+ */
+int dice_rng_roll_uniform(DiceRng* rng, int faces);
+
+/**
+ * Rolls a non-uniform die with weighted probabilities using the given generator.
+ * @param rng Generator to draw from.
+ * @param faces Number of die faces.
+ * @param probabilities Array of `faces` positive integer weights summing to
+ *                      at most INT_MAX (a fair roll is made otherwise).
+ * @return A value between 1 and faces, based on weighted probability.
+ */
+int dice_rng_roll_non_uniform(DiceRng* rng, int faces, const int* probabilities);
+
 /**
  * Validates the probability array for non-uniform die.
  * @param probabilities Array of probabilities.
  * @param faces Number of faces.
- * @return true if valid (all values > 0), false if invalid.
+ * @return true if valid (all values > 0, sum at most INT_MAX), false if invalid.
  */
 bool dice_validate_probabilities(const int* probabilities, int faces);
 
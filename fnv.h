@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL  // Initial value of a 64-bit FNV-1a hash
+#define FNV_PRIME        0x100000001b3ULL
+
+/**
+ * Continues a 64-bit FNV-1a hash over a byte buffer.
+ */
+static inline uint64_t fnv_hash_bytes(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * Continues a 64-bit FNV-1a hash over the 8 bytes of `value`, least
+ * significant first, so the result does not depend on the host byte order.
+ */
+static inline uint64_t fnv_hash_u64(uint64_t hash, uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (value >> (8 * i)) & 0xFF;
+    return fnv_hash_bytes(hash, bytes, sizeof(bytes));
+}
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "dice.h"
+#include "rules.h"
+
+#define GENBOARD_DEFAULT_SEED    1
+#define GENBOARD_DEFAULT_DENSITY 0.1   // Jumps per square when no counts are given
+#define GENBOARD_MAX_ATTEMPTS    32    // Random tries per jump before giving up on it
+
+/**
+ * Generator for synthetic board configurations, used to benchmark and soak
+ * test the simulator on boards far larger than the hand-written ones.
+ *
+ * Snakes and ladders are placed at random (reproducibly, from the seed)
+ * through board_add_snake()/board_add_ladder(), so the output honours the
+ * same conflict rules as the config loader and loads without warnings.
+ * Generation is linear in the number of jumps.
+ */
+
+/**
+ * Uniform random integer in [1, n] (n may exceed MAX_DIE_FACES).
+ */
+static int random_between(DiceRng* rng, int n) {
+    int value = 1 + (int)(dice_rng_unit(rng) * n);
+    return value > n ? n : value;
+}
+
+/**
+ * Picks a random jump of at most `span` squares and tries to add it.
+ * Returns true if the jump was added.
+ */
+static bool try_add_jump(Board* board, DiceRng* rng, int span, bool snake) {
+    // Neither end on square 1 (the start) and no jump leaves the final square
+    int start = 1 + random_between(rng, board->size - 2);
+    int length = random_between(rng, span);
+
+    if (snake) {
+        int end = start - length;
+        return end >= 2 && board_add_snake(board, start, end);
+    }
+    int end = start + length;
+    return end <= board->size && board_add_ladder(board, start, end);
+}
+
+/**
+ * Places up to `count` jumps of one kind. Returns the number placed.
+ */
+static int place_jumps(Board* board, DiceRng* rng, int span, bool snake, int count) {
+    int placed = 0;
+    for (int i = 0; i < count; i++) {
+        for (int attempt = 0; attempt < GENBOARD_MAX_ATTEMPTS; attempt++) {
+            if (try_add_jump(board, rng, span, snake)) {
+                placed++;
+                break;
+            }
+        }
+    }
+    return placed;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s <width> <height> [--snakes <n>] [--ladders <n>] [--density <jumps per square>]\n", program);
+    printf("       %*s [--span <max jump length>] [--seed <n>] [--rule <name>]...\n", (int)strlen(program), "");
+    printf("Writes a board configuration to stdout.\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    int num_snakes = -1, num_ladders = -1;
+    double density = GENBOARD_DEFAULT_DENSITY;
+    int span = 0;
+    unsigned long long seed = GENBOARD_DEFAULT_SEED;
+    RuleSet rules = 0;
+    const char* rule_names[argc];  // Echoed as RULE lines, in the given order
+    int num_rules = 0;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--snakes") == 0 && i + 1 < argc) {
+            num_snakes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ladders") == 0 && i + 1 < argc) {
+            num_ladders = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--density") == 0 && i + 1 < argc) {
+            density = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--span") == 0 && i + 1 < argc) {
+            span = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rule") == 0 && i + 1 < argc) {
+            if (!rules_add(&rules, argv[++i])) {
+                fprintf(stderr, "❌ Invalid or conflicting rule: %s\n", argv[i]);
+                return 1;
+            }
+            rule_names[num_rules++] = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Board board;
+    memset(&board, 0, sizeof(board));
+    if (width * (long)height < 4 || !board_init(&board, width, height)) {
+        fprintf(stderr, "❌ Invalid board size %dx%d (at most %dx%d)\n",
+                width, height, MAX_BOARD_WIDTH, MAX_BOARD_HEIGHT);
+        return 1;
+    }
+    board.rules = rules;
+
+    // Counts default to `density` jumps per square, split evenly
+    int total = (int)(density * board.size);
+    if (num_snakes < 0) num_snakes = total / 2;
+    if (num_ladders < 0) num_ladders = total - total / 2;
+    if (num_snakes < 0 || num_ladders < 0 || density < 0.0) {
+        fprintf(stderr, "❌ Invalid number of jumps\n");
+        board_free(&board);
+        return 1;
+    }
+
+    // Jumps span up to two rows by default, like on a printed board
+    if (span <= 0) span = 2 * width;
+    if (span > board.size - 2) span = board.size - 2;
+
+    DiceRng rng;
+    dice_rng_seed(&rng, seed);
+
+    // Alternate between kinds so neither gets the free squares first
+    int placed_snakes = 0, placed_ladders = 0;
+    int rounds = num_snakes > num_ladders ? num_snakes : num_ladders;
+    for (int i = 0; i < rounds; i++) {
+        if (i < num_ladders) placed_ladders += place_jumps(&board, &rng, span, false, 1);
+        if (i < num_snakes) placed_snakes += place_jumps(&board, &rng, span, true, 1);
+    }
+    if (placed_snakes < num_snakes || placed_ladders < num_ladders) {
+        fprintf(stderr, "⚠️ Board too crowded: placed %d/%d snakes and %d/%d ladders\n",
+                placed_snakes, num_snakes, placed_ladders, num_ladders);
+    }
+
+    printf("# Generated board: %dx%d, seed %llu, %d snakes, %d ladders\n",
+           width, height, seed, board.num_snakes, board.num_ladders);
+    printf("BOARD %d %d\n", width, height);
+    for (int i = 0; i < num_rules; i++) {
+        printf("RULE %s\n", rule_names[i]);
+    }
+    for (int i = 0; i < board.num_ladders; i++) {
+        printf("LADDER %d %d\n", board.ladders[i].start, board.ladders[i].end);
+    }
+    for (int i = 0; i < board.num_snakes; i++) {
+        printf("SNAKE %d %d\n", board.snakes[i].start, board.snakes[i].end);
+    }
+
+    board_free(&board);
+    return 0;
+}
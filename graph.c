@@ -1,5 +1,6 @@
 #include "graph.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 /**
  * Builds a graph representation of the game board.
@@ -7,37 +8,56 @@
  * Each edge represents a legal move (via dice roll + jump).
  *
  * If a square contains a ladder or snake, the edge points to its end.
+ * Overshooting rolls follow the board's rules (stay in place, bounce back or
+ * finish), so every non-final node has exactly `die_faces` edges, in roll
+ * order. RULE_THREE_MAX_HOME depends on roll history, not just the square,
+ * and is not represented in the graph.
  *
  * @param graph Pointer to the graph structure to populate.
  * @param board The board configuration (with snakes/ladders).
  * @param die_faces Number of faces on the die (e.g., 6).
+ * @return true on success, false otherwise.
  */
-void graph_build(Graph* graph, const Board* board, int die_faces) {
-    if (!graph || !board || die_faces <= 0) return;
+bool graph_build(Graph* graph, const Board* board, int die_faces) {
+    if (!graph) return false;
+
+    graph->num_nodes = 0;
+    graph->die_faces = 0;
+    graph->neighbors = NULL;
+    if (!board || board->size < 1 || die_faces <= 0 || die_faces > MAX_NEIGHBORS) return false;
+
+    graph->neighbors = malloc(((size_t)board->size + 1) * die_faces * sizeof(int));
+    if (!graph->neighbors) return false;
 
     graph->num_nodes = board->size;
+    graph->die_faces = die_faces;
 
     // For each square on the board, determine reachable neighbors
-    for (int i = 1; i <= board->size; i++) {
-        graph->nodes[i].index = i;
-        graph->nodes[i].num_neighbors = 0;
+    // (the final square ends the game and keeps no edges)
+    for (int i = 1; i < board->size; i++) {
+        int* row = graph->neighbors + (size_t)i * die_faces;
 
         // Simulate dice rolls from this square
         for (int roll = 1; roll <= die_faces; roll++) {
-            int next_pos = i + roll;
+            // Overshoot rule, then ladder or snake
+            int next_pos = rules_target(board->rules, board->size, i, roll);
+            row[roll - 1] = (next_pos == i) ? i : board_apply_jump(board, next_pos);
+        }
+    }
 
-            // Skip moves that go off the board
-            if (next_pos > board->size) continue;
+    return true;
+}
 
-            // Apply jump if there's a ladder or snake
-            int final_pos = board_apply_jump(board, next_pos);
+/**
+ * Frees the adjacency array and empties the graph.
+ */
+void graph_free(Graph* graph) {
+    if (!graph) return;
 
-            // Add the final position as a neighbor if within limits
-            if (graph->nodes[i].num_neighbors < MAX_NEIGHBORS) {
-                graph->nodes[i].neighbors[graph->nodes[i].num_neighbors++] = final_pos;
-            }
-        }
-    }
+    free(graph->neighbors);
+    graph->neighbors = NULL;
+    graph->num_nodes = 0;
+    graph->die_faces = 0;
 }
 
 /**
@@ -45,14 +65,15 @@ void graph_build(Graph* graph, const Board* board, int die_faces) {
  * Each node (square) lists reachable neighbors (target squares).
  */
 void graph_print(const Graph* graph) {
-    if (!graph) return;
+    if (!graph || !graph->neighbors) return;
 
     printf("Graph representation of the board:\n");
 
     for (int i = 1; i <= graph->num_nodes; i++) {
+        const int* row = graph_neighbors(graph, i);
         printf("Node %3d: ", i);
-        for (int j = 0; j < graph->nodes[i].num_neighbors; j++) {
-            printf("%3d ", graph->nodes[i].neighbors[j]);
+        for (int j = 0; j < graph_degree(graph, i); j++) {
+            printf("%3d ", row[j]);
         }
         printf("\n");
     }
@@ -1,38 +1,61 @@
 #pragma once
 
 #include "board.h"
+#include "dice.h"
+#include <stdbool.h>
 
-#define MAX_NEIGHBORS 6  // Maximum direct transitions (e.g., dice roll 1–6)
-
-/**
- * Represents a node (square) on the game board.
- * Each node stores its index and a list of reachable neighbors.
- */
-typedef struct {
-    int index;                    // Square number (e.g., 1, 2, ..., 100)
-    int neighbors[MAX_NEIGHBORS]; // Squares reachable from this node after one dice roll
-    int num_neighbors;            // Actual number of neighbors
-} GraphNode;
+#define MAX_NEIGHBORS MAX_DIE_FACES  // One transition per die face
 
 /**
  * Represents the graph corresponding to the game board.
- * Each node corresponds to one square on the board.
+ * Each square 1..num_nodes is a node. Every node except the final square
+ * has exactly `die_faces` outgoing edges stored contiguously:
+ * graph_neighbors(graph, square)[r - 1] is the square reached by rolling r,
+ * so the edges can be weighted with the die probabilities.
+ * The adjacency array is allocated by graph_build() and released by graph_free().
  */
 typedef struct {
-    GraphNode nodes[MAX_BOARD_SIZE + 1];  // One node per square (1-indexed)
-    int num_nodes;                        // Total number of board squares
+    int num_nodes;   // Total number of board squares
+    int die_faces;   // Edges per non-final node
+    int* neighbors;  // (num_nodes + 1) * die_faces entries, row per square
 } Graph;
 
 /**
  * Builds the graph from the board and die configuration.
  * Adds directed edges from each node to its reachable positions after dice roll,
- * considering the effect of snakes and ladders.
+ * considering the effect of snakes and ladders. Rolls that overshoot the
+ * final square follow board->rules (with the classic rules they are a
+ * self-loop). The final square is absorbing and has no outgoing edges.
+ * Runs in O(size * die_faces).
  *
- * @param graph Pointer to the graph structure to populate.
+ * @param graph Pointer to the graph structure to populate (must not hold
+ *              allocations from an earlier graph_build()).
  * @param board Pointer to the board structure.
  * @param die_faces Number of faces on the die (e.g., 6).
+ * @return true on success, false on invalid parameters or allocation failure.
+ */
+bool graph_build(Graph* graph, const Board* board, int die_faces);
+
+/**
+ * Releases the adjacency array of a graph. Safe to call on a zeroed graph.
+ *
+ * @param graph Pointer to the graph.
+ */
+void graph_free(Graph* graph);
+
+/**
+ * Number of outgoing edges of a square (0 for the final square).
+ */
+static inline int graph_degree(const Graph* graph, int square) {
+    return (square == graph->num_nodes) ? 0 : graph->die_faces;
+}
+
+/**
+ * Outgoing edges of a square, indexed by roll - 1.
  */
-void graph_build(Graph* graph, const Board* board, int die_faces);
+static inline const int* graph_neighbors(const Graph* graph, int square) {
+    return graph->neighbors + (size_t)square * graph->die_faces;
+}
 
 /**
  * Prints the graph structure to stdout (for debugging and visualization).
@@ -0,0 +1,110 @@
+#include "heatmap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Initializes an empty heatmap sized for the board.
+ */
+bool heatmap_init(Heatmap* heatmap, const Board* board) {
+    if (!heatmap) return false;
+
+    memset(heatmap, 0, sizeof(*heatmap));
+    if (!board || board->size < 1) return false;
+
+    heatmap->counts = calloc((size_t)board->size + 1, sizeof(uint64_t));
+    if (!heatmap->counts) return false;
+
+    heatmap->width = board->width;
+    heatmap->height = board->height;
+    heatmap->size = board->size;
+    return true;
+}
+
+/**
+ * Frees the counts and zeroes the heatmap.
+ */
+void heatmap_free(Heatmap* heatmap) {
+    if (!heatmap) return;
+
+    free(heatmap->counts);
+    memset(heatmap, 0, sizeof(*heatmap));
+}
+
+/**
+ * Allocates one thread's counters on whole cache lines of their own.
+ */
+uint64_t* heatmap_thread_counters(const Heatmap* heatmap) {
+    if (!heatmap || heatmap->size < 1) return NULL;
+
+    size_t bytes = ((size_t)heatmap->size + 1) * sizeof(uint64_t);
+    bytes = (bytes + HEATMAP_CACHE_LINE - 1) / HEATMAP_CACHE_LINE * HEATMAP_CACHE_LINE;
+
+    uint64_t* counters = aligned_alloc(HEATMAP_CACHE_LINE, bytes);
+    if (counters) memset(counters, 0, bytes);
+    return counters;
+}
+
+/**
+ * Adds a thread's counters to the merged counts.
+ */
+void heatmap_merge(Heatmap* heatmap, const uint64_t* counters, uint64_t games) {
+    if (!heatmap || !heatmap->counts || !counters) return;
+
+    for (int s = 1; s <= heatmap->size; s++) {
+        heatmap->counts[s] += counters[s];
+    }
+    heatmap->games += games;
+}
+
+/**
+ * Square shown at column x of image row y (row 0 is the top of the board).
+ * Squares run left to right on the bottom row, then alternate direction.
+ */
+static int square_at(const Heatmap* heatmap, int x, int y) {
+    int row = heatmap->height - 1 - y;  // Counted from the bottom
+    int column = (row % 2 == 0) ? x : heatmap->width - 1 - x;
+    return row * heatmap->width + column + 1;
+}
+
+/**
+ * Writes the counts as a width x height CSV grid.
+ */
+bool heatmap_write_csv(const Heatmap* heatmap, FILE* file) {
+    if (!heatmap || !heatmap->counts || !file) return false;
+
+    for (int y = 0; y < heatmap->height; y++) {
+        for (int x = 0; x < heatmap->width; x++) {
+            fprintf(file, "%s%llu", x ? "," : "",
+                    (unsigned long long)heatmap->counts[square_at(heatmap, x, y)]);
+        }
+        fputc('\n', file);
+    }
+    return !ferror(file);
+}
+
+/**
+ * Writes the counts as an 8-bit PGM (P5) image scaled to the busiest square.
+ */
+bool heatmap_write_pgm(const Heatmap* heatmap, FILE* file) {
+    if (!heatmap || !heatmap->counts || !file) return false;
+
+    uint64_t max = 0;
+    for (int s = 1; s <= heatmap->size; s++) {
+        if (heatmap->counts[s] > max) max = heatmap->counts[s];
+    }
+
+    unsigned char* row = malloc(heatmap->width);
+    if (!row) return false;
+
+    fprintf(file, "P5\n%d %d\n255\n", heatmap->width, heatmap->height);
+    for (int y = 0; y < heatmap->height; y++) {
+        for (int x = 0; x < heatmap->width; x++) {
+            uint64_t count = heatmap->counts[square_at(heatmap, x, y)];
+            row[x] = max ? (unsigned char)((double)count * 255.0 / (double)max + 0.5) : 0;
+        }
+        fwrite(row, 1, heatmap->width, file);
+    }
+
+    free(row);
+    return !ferror(file);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "board.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define HEATMAP_CACHE_LINE 64  // Alignment and padding of per-thread counter arrays
+
+/**
+ * Landing counts per square, merged from one or more simulation threads.
+ * A landing is the square a player rests on after a roll (after any snake
+ * or ladder), including staying in place on an overshoot.
+ */
+typedef struct {
+    int width;          // Board width, for the exported layout
+    int height;         // Board height
+    int size;           // Number of squares
+    uint64_t* counts;   // Landings per square, index 1..size
+    uint64_t games;     // Games the counts were collected over
+} Heatmap;
+
+/**
+ * Initializes an empty heatmap for the board. Release it with heatmap_free().
+ *
+ * @param heatmap Pointer to the heatmap.
+ * @param board Pointer to the board.
+ * @return true on success, false on invalid parameters or allocation failure.
+ */
+bool heatmap_init(Heatmap* heatmap, const Board* board);
+
+/**
+ * Releases the counts of a heatmap. Safe to call on a zeroed heatmap.
+ *
+ * @param heatmap Pointer to the heatmap.
+ */
+void heatmap_free(Heatmap* heatmap);
+
+/**
+ * Allocates a zeroed counter array for one simulation thread, indexed by
+ * square (1..size). The array is aligned to and padded up to whole cache
+ * lines, so threads counting into their own arrays never share a line.
+ * Release it with free().
+ *
+ * @param heatmap Heatmap the counters will be merged into.
+ * @return The counters, or NULL on allocation failure.
+ */
+uint64_t* heatmap_thread_counters(const Heatmap* heatmap);
+
+/**
+ * Adds one thread's counters to the heatmap.
+ *
+ * @param heatmap Pointer to the heatmap.
+ * @param counters Counters from heatmap_thread_counters().
+ * @param games Number of games the counters were collected over.
+ */
+void heatmap_merge(Heatmap* heatmap, const uint64_t* counters, uint64_t games);
+
+/**
+ * Writes the heatmap as CSV: `height` lines of `width` counts, laid out
+ * like the printed board (square 1 bottom left, rows alternating direction,
+ * final row on the first line).
+ *
+ * @param heatmap Pointer to the heatmap.
+ * @param file Output stream.
+ * @return true on success, false on a write error.
+ */
+bool heatmap_write_csv(const Heatmap* heatmap, FILE* file);
+
+/**
+ * Writes the heatmap as a binary 8-bit greyscale PGM image, one pixel per
+ * square in the same layout as heatmap_write_csv(). Brightness is
+ * proportional to the landing count (white = most visited square).
+ *
+ * @param heatmap Pointer to the heatmap.
+ * @param file Output stream (opened in binary mode).
+ * @return true on success, false on a write error.
+ */
+bool heatmap_write_pgm(const Heatmap* heatmap, FILE* file);
@@ -1,19 +1,253 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "board.h"
 #include "dice.h"
 #include "simulator.h"
 #include "stats.h"
+#include "rare.h"
+#include "graph.h"
+#include "analysis.h"
+#include "pipeline.h"
+#include "server.h"
+#include "heatmap.h"
+#include "optimizer.h"
+#include "resultcache.h"
 
 #include "config.h"  
+
+#define PRINT_MAX_ROLLS MOVE_CAP_MIN  // Rolls of the shortest game shown before eliding the rest
+
+/**
+ * Prints the roll sequence of the shortest winning game, or a notice if
+ * no game was won (`best` is NULL).
+ */
+static void print_shortest_win(const GameResult* best) {
+    if (!best) {
+        printf("\n⚠️ No winning game found during simulation.\n");
+        return;
+    }
+
+    printf("\n🏆 Shortest winning game found in %d moves:\n", best->move_count);
+    printf("    Roll sequence: ");
+    for (int i = 0; i < best->move_count && i < PRINT_MAX_ROLLS; i++) {
+        printf("%d ", best->moves[i]);
+    }
+    if (best->move_count > PRINT_MAX_ROLLS) printf("... (%d more)", best->move_count - PRINT_MAX_ROLLS);
+    printf("\n");
+}
+
+/**
+ * Prints the die found by optimize_die_weights(), with the gradient projected
+ * onto the simplex.
+ */
+static void print_optimized_die(const OptimizerResult* result, int die_faces, double target) {
+    // The probabilities sum to 1, so only the gradient minus its mean is a feasible direction
+    double mean = 0.0;
+    for (int r = 0; r < die_faces; r++) mean += result->gradient[r] / die_faces;
+
+    printf("\n🎯 Die weights for %.2f expected moves (%s after %d steps):\n",
+           target, result->converged ? "converged" : "closest within bounds", result->iterations);
+    for (int r = 0; r < die_faces; r++) {
+        printf("  Face %d: weight %4d  (p = %.4f, dE/dp = %+.2f)\n", r + 1, result->weights[r],
+               result->probabilities[r], result->gradient[r] - mean);
+    }
+    printf("  Exact expected moves: %.4f (%.4f with the rounded weights)\n",
+           result->expected_moves, result->weighted_expected_moves);
+}
+
+/**
+ * Prints the average game length of won games: in rolls, and in turns when
+ * extra rolls make the two differ.
+ */
+static void print_average(const Board* board, uint64_t wins, uint64_t total_moves, uint64_t total_turns) {
+    double avg = wins ? (double)total_moves / wins : 0.0;
+    if (board->rules & RULE_REROLL_ON_MAX) {
+        double avg_turns = wins ? (double)total_turns / wins : 0.0;
+        printf("📈 Average number of moves to win: %.2f (%.2f turns)\n", avg, avg_turns);
+    } else {
+        printf("📈 Average number of moves to win: %.2f\n", avg);
+    }
+}
+
+/**
+ * Prints the average, shortest win and snake and ladder usage of a run.
+ */
+static void print_run(const Board* board, const RunResult* run) {
+    print_average(board, run->wins, run->total_moves, run->total_turns);
+    print_shortest_win(run->found_win ? &run->shortest : NULL);
+    stats_print(board, &run->stats);
+}
+
+/**
+ * Runs the seeded simulation through the on-disk result cache in `directory`:
+ * a checkpoint of exactly `num_games` games is printed as is, otherwise the
+ * largest smaller checkpoint is extended from its saved generator state and
+ * stored back as a new checkpoint. The results are always those of exactly
+ * `num_games` games.
+ * Returns false if the run could not be set up.
+ */
+static bool run_with_cache(const Board* board, int die_faces, bool use_non_uniform, const int* probabilities,
+                           uint64_t num_games, uint64_t seed, const char* directory, double progress_interval) {
+    RunResult run;
+    if (!run_result_init(&run, board, seed)) return false;
+
+    uint64_t key = result_cache_key(board, die_faces, use_non_uniform, probabilities, seed);
+    bool hit = result_cache_load(directory, key, board, die_faces, num_games, &run);
+    uint64_t cached = run.games;
+
+    if (run.games < num_games) {
+        Progress progress;
+        bool reporting = progress_interval > 0.0 &&
+                         progress_start(&progress, num_games - run.games, progress_interval, stderr);
+        bool extended = run_result_extend(&run, board, die_faces, use_non_uniform, probabilities,
+                                          num_games - run.games, NULL, reporting ? &progress : NULL);
+        if (reporting) progress_stop(&progress);
+        if (!extended) {
+            run_result_free(&run);
+            return false;
+        }
+
+        if (!result_cache_store(directory, key, board, die_faces, &run)) {
+            fprintf(stderr, "⚠️ Could not write the result cache in %s\n", directory);
+        }
+    }
+
+    if (!hit) {
+        printf("💾 Result cache miss: simulated %llu games\n", (unsigned long long)run.games);
+    } else if (cached < num_games) {
+        printf("💾 Result cache: extended %llu cached games to %llu\n",
+               (unsigned long long)cached, (unsigned long long)run.games);
+    } else {
+        printf("💾 Result cache hit: %llu games cached\n", (unsigned long long)run.games);
+    }
+
+    print_run(board, &run);
+    run_result_free(&run);
+    return true;
+}
+
+/**
+ * Writes the landing heatmap to `path`: a PGM image if the name ends in
+ * ".pgm", CSV otherwise.
+ */
+static bool write_heatmap(const Heatmap* heatmap, const char* path) {
+    size_t length = strlen(path);
+    bool pgm = length >= 4 && strcmp(path + length - 4, ".pgm") == 0;
+
+    FILE* file = fopen(path, pgm ? "wb" : "w");
+    if (!file) {
+        perror("Failed to open heatmap file");
+        return false;
+    }
+    bool ok = pgm ? heatmap_write_pgm(heatmap, file) : heatmap_write_csv(heatmap, file);
+    ok = (fclose(file) == 0) && ok;
+    if (ok) printf("\n🗺️ Landing heatmap over %llu games written to %s\n",
+                   (unsigned long long)heatmap->games, path);
+    return ok;
+}
+
+/**
+ * Parses the options of `--server` and `--batch` modes and runs the job server
+ * or the batch of jobs.
+ */
+static int run_server(int argc, char* argv[], const char* batch_file) {
+    ServerOptions options = { NULL, SERVER_DEFAULT_WORKERS, SERVER_DEFAULT_CACHE_SIZE, 0.0 };
+
+    for (int i = batch_file ? 3 : 2; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            options.socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options.num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            options.cache_capacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc) {
+            options.progress_interval = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "❌ Unknown server option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    return batch_file ? server_run_batch(batch_file, &options) : server_run(&options);
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        printf("Usage: %s <board_config_file>\n", argv[0]);
+        printf("Usage: %s <board_config_file> [--games <n>] [--tail <moves>] [--tail-bias <factor>] [--tail-games <n>] [--force]\n", argv[0]);
+        printf("       %*s [--pipeline <workers>] [--aggregators <n>] [--games-out <file>] [--heatmap <file.csv|file.pgm>]\n"
+               "       %*s [--progress <seconds>] [--optimize <moves>] [--min-prob <p>] [--max-prob <p>]\n"
+               "       %*s [--seed <n>] [--cache-dir <dir>]\n", (int)strlen(argv[0]), "", (int)strlen(argv[0]), "", (int)strlen(argv[0]), "");
+        printf("       %s --server [--socket <path>] [--workers <n>] [--cache <boards>]\n", argv[0]);
+        printf("       %s --batch <jobs_file> [--workers <n>] [--progress <seconds>]\n", argv[0]);
         return 1;
     }
 
+    if (strcmp(argv[1], "--server") == 0) {
+        return run_server(argc, argv, NULL);
+    }
+    if (strcmp(argv[1], "--batch") == 0 && argc >= 3) {
+        return run_server(argc, argv, argv[2]);
+    }
+
     const char* config_file = argv[1];
+    int tail_threshold = 0;              // 0 disables the rare-event estimate
+    double tail_bias = TAIL_BIAS_AUTO;
+    long long tail_games = 100000;
+    bool force = false;                  // Simulate even if the preflight check fails
+    long long num_games = 1000;
+    double progress_interval = 0.0;      // 0 disables the progress reporter
+    PipelineOptions pipeline = { 0, 1, 0, NULL, NULL, NULL };  // 0 workers: run sequentially
+    const char* games_out_file = NULL;
+    const char* heatmap_file = NULL;
+    OptimizerOptions optimizer = { 0.0, 0.02, 0.5, 0, 0.0 };  // Target 0: no optimisation
+    bool seeded = false;                 // --seed given: reproducible run
+    uint64_t seed = 0;
+    const char* cache_dir = NULL;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--tail") == 0 && i + 1 < argc) {
+            tail_threshold = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tail-bias") == 0 && i + 1 < argc) {
+            tail_bias = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tail-games") == 0 && i + 1 < argc) {
+            tail_games = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--force") == 0) {
+            force = true;
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            num_games = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc) {
+            progress_interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            pipeline.num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--aggregators") == 0 && i + 1 < argc) {
+            pipeline.num_aggregators = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--games-out") == 0 && i + 1 < argc) {
+            games_out_file = argv[++i];
+        } else if (strcmp(argv[i], "--heatmap") == 0 && i + 1 < argc) {
+            heatmap_file = argv[++i];
+        } else if (strcmp(argv[i], "--optimize") == 0 && i + 1 < argc) {
+            optimizer.target_moves = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-prob") == 0 && i + 1 < argc) {
+            optimizer.min_probability = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-prob") == 0 && i + 1 < argc) {
+            optimizer.max_probability = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+            seeded = true;
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else {
+            fprintf(stderr, "❌ Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (cache_dir && (!seeded || pipeline.num_workers > 0 || heatmap_file)) {
+        fprintf(stderr, "❌ --cache-dir needs --seed and runs sequentially without --heatmap\n");
+        return 1;
+    }
 
     Board board;
     if (!load_board_from_file(&board, config_file)) {
@@ -23,36 +257,166 @@ int main(int argc, char* argv[]) {
 
     board_print(&board);
     dice_init();
+    if (seeded) dice_rng_seed(dice_default_rng(), seed);
 
-    const int NUM_GAMES = 1000;
     const int DIE_FACES = 6;
     bool use_non_uniform = false;
     int probabilities[MAX_DIE_FACES] = {1, 1, 1, 1, 1, 1};
 
-    printf("\n🔁 Simulating %d games...\n", NUM_GAMES);
-    double avg_moves = simulate_average_moves(&board, DIE_FACES, NUM_GAMES, use_non_uniform, probabilities);
-    printf("📈 Average number of moves to win: %.2f\n", avg_moves);
+    Graph graph;
+    bool built = graph_build(&graph, &board, DIE_FACES);
 
-    GameResult best_result;
-    if (simulate_shortest_win(&board, DIE_FACES, NUM_GAMES, use_non_uniform, probabilities, &best_result)) {
-        printf("\n🏆 Shortest winning game found in %d moves:\n", best_result.move_count);
-        printf("    Roll sequence: ");
-        for (int i = 0; i < best_result.move_count; i++) {
-            printf("%d ", best_result.moves[i]);
+    // Optional: tune the die weights to the target length, then simulate with them
+    if (optimizer.target_moves > 0.0) {
+        OptimizerResult optimized;
+        const char* error = "out of memory";
+        if (!built || !optimize_die_weights(&graph, &board, probabilities, &optimizer, &optimized, &error)) {
+            fprintf(stderr, "❌ Cannot optimise the die for this board and bounds: %s\n", error);
+            graph_free(&graph);
+            board_free(&board);
+            return 1;
         }
-        printf("\n");
+        print_optimized_die(&optimized, DIE_FACES, optimizer.target_moves);
+        use_non_uniform = true;
+        memcpy(probabilities, optimized.weights, sizeof(int) * DIE_FACES);
+    }
+
+    // Preflight: refuse boards whose games would all run into the move cap
+    BoardAnalysis analysis;
+    bool analyzed = built &&
+                    graph_analyze(&graph, &board, DIE_FACES, use_non_uniform, probabilities, &analysis);
+    graph_free(&graph);
+    if (analyzed) {
+        analysis_print(&analysis);
+        if (analysis.health == BOARD_BROKEN && !force) {
+            fprintf(stderr, "❌ Board cannot be won, not simulating (use --force to override)\n");
+            board_free(&board);
+            return 1;
+        }
+    }
+
+    if (num_games <= 0) {
+        fprintf(stderr, "❌ Invalid number of games: %lld\n", num_games);
+        board_free(&board);
+        return 1;
+    }
+
+    Heatmap heatmap;
+    memset(&heatmap, 0, sizeof(heatmap));
+    if (heatmap_file && !heatmap_init(&heatmap, &board)) {
+        fprintf(stderr, "❌ Failed to allocate the heatmap\n");
+        board_free(&board);
+        return 1;
+    }
+
+    printf("\n🔁 Simulating %lld games...\n", num_games);
+    fflush(stdout);
+
+    // Reports the pipelined or sequential run (the cached run starts its own)
+    Progress progress;
+    bool reporting = !cache_dir && progress_interval > 0.0 &&
+                     progress_start(&progress, (uint64_t)num_games, progress_interval, stderr);
+
+    if (cache_dir) {
+        if (!run_with_cache(&board, DIE_FACES, use_non_uniform, probabilities, (uint64_t)num_games,
+                            seed, cache_dir, progress_interval)) {
+            fprintf(stderr, "❌ Cached simulation failed\n");
+            board_free(&board);
+            return 1;
+        }
+    } else if (pipeline.num_workers > 0) {
+        if (games_out_file) {
+            pipeline.games_out = fopen(games_out_file, "w");
+            if (!pipeline.games_out) {
+                perror("Failed to open per-game output file");
+                if (reporting) progress_stop(&progress);
+                heatmap_free(&heatmap);
+                board_free(&board);
+                return 1;
+            }
+        }
+        pipeline.seed = seeded ? seed : (uint64_t)time(NULL);
+        if (heatmap_file) pipeline.heatmap = &heatmap;
+        if (reporting) pipeline.progress = &progress;
+
+        PipelineReport report;
+        bool ran = pipeline_run(&board, DIE_FACES, use_non_uniform, probabilities,
+                                (uint64_t)num_games, &pipeline, &report);
+        if (pipeline.games_out) fclose(pipeline.games_out);
+        if (reporting) progress_stop(&progress);
+        if (!ran) {
+            fprintf(stderr, "❌ Pipelined simulation failed\n");
+            heatmap_free(&heatmap);
+            board_free(&board);
+            return 1;
+        }
+
+        print_average(&board, report.wins, report.total_moves, report.total_turns);
+        print_shortest_win(report.found_win ? &report.shortest : NULL);
+        stats_print(&board, &report.stats);
+        pipeline_print_report(&report);
+        pipeline_report_free(&report);
     } else {
-        printf("\n⚠️ No winning game found during simulation.\n");
+        // One pass collects the average, shortest win, usage stats and landings
+        RunResult run;
+        uint64_t* occupancy = heatmap_file ? heatmap_thread_counters(&heatmap) : NULL;
+        bool ran = (!heatmap_file || occupancy) &&
+                   run_result_init(&run, &board, seeded ? seed : (uint64_t)time(NULL));
+        if (ran) {
+            ran = run_result_extend(&run, &board, DIE_FACES, use_non_uniform, probabilities,
+                                    (uint64_t)num_games, occupancy, reporting ? &progress : NULL);
+            if (!ran) run_result_free(&run);
+        }
+        if (reporting) progress_stop(&progress);
+        if (!ran) {
+            fprintf(stderr, "❌ Simulation failed\n");
+            free(occupancy);
+            heatmap_free(&heatmap);
+            board_free(&board);
+            return 1;
+        }
+
+        print_run(&board, &run);
+        run_result_free(&run);
+        heatmap_merge(&heatmap, occupancy, (uint64_t)num_games);
+        free(occupancy);
     }
 
-    Stats stats;
-    stats_init(&stats);
-    for (int i = 0; i < NUM_GAMES; i++) {
-        GameResult result;
-        simulate_game(&board, DIE_FACES, &result, use_non_uniform, probabilities);
-        stats_update(&board, &result, &stats);
+    if (heatmap_file) {
+        if (!write_heatmap(&heatmap, heatmap_file)) {
+            fprintf(stderr, "⚠️ Could not write heatmap to %s\n", heatmap_file);
+        }
+        heatmap_free(&heatmap);
+    }
+
+    if (tail_threshold > 0) {
+        TailEstimate tail;
+        const char* error = "invalid number of games";
+        if (tail_games > 0 &&
+            simulate_tail_probability(&board, DIE_FACES, use_non_uniform, probabilities,
+                                      tail_threshold, (uint64_t)tail_games, tail_bias, &tail, &error)) {
+            char method[64];
+            if (tail.bias == TAIL_BIAS_AUTO) {
+                snprintf(method, sizeof(method), "ESS %.0f, splitting", tail.effective_samples);
+            } else {
+                snprintf(method, sizeof(method), "ESS %.0f, bias %.2f", tail.effective_samples, tail.bias);
+            }
+            if (tail.reliable) {
+                printf("\n🐢 P(moves > %d) ≈ %.3e (± %.1e, %llu/%llu games in tail, %s)\n",
+                       tail_threshold, tail.probability, tail.std_error,
+                       (unsigned long long)tail.hits, (unsigned long long)tail.num_games, method);
+            } else {
+                printf("\n🐢 P(moves > %d) ≈ %.3e (unreliable, %llu/%llu games in tail, %s)\n",
+                       tail_threshold, tail.probability,
+                       (unsigned long long)tail.hits, (unsigned long long)tail.num_games, method);
+                fprintf(stderr, "⚠️ A few samples dominate the tail estimate, its error cannot be judged; "
+                                "try more --tail-games%s\n", tail.bias == TAIL_BIAS_AUTO ? "" : " or another --tail-bias");
+            }
+        } else {
+            fprintf(stderr, "⚠️ Cannot estimate the tail probability: %s\n", error);
+        }
     }
 
-    stats_print(&board, &stats);
+    board_free(&board);
     return 0;
 }
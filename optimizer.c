@@ -0,0 +1,541 @@
+#include "optimizer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PIVOT_EPSILON    1e-12  // Pivots below this mean the chain is not absorbing
+#define SOLVER_TOLERANCE 1e-10  // Relative residual accepted by the iterative solver
+#define SOLVER_MAX_ITER  5000   // BiCGSTAB steps before a solve is declared failed
+#define MIN_STEP         1e-14  // Step size at which the search gives up
+#define PROJECTION_ITER  100    // Bisection steps of the simplex projection
+
+/**
+ * Numbers the transient squares reachable from square 1 in board order, so
+ * that I - Q is upper triangular but for the backward jumps. index[s] is the
+ * row of square s, or -1. Returns the count.
+ */
+static int index_transient_squares(const Graph* graph, int* index, int* order) {
+    int goal = graph->num_nodes;
+    for (int s = 0; s <= goal; s++) index[s] = -1;
+
+    int count = 0, head = 0;
+    index[1] = count;
+    order[count++] = 1;
+    while (head < count) {
+        int square = order[head++];
+        const int* neighbors = graph_neighbors(graph, square);
+        for (int j = 0; j < graph_degree(graph, square); j++) {
+            int next = neighbors[j];
+            if (next != goal && index[next] < 0) {
+                index[next] = count;
+                order[count++] = next;
+            }
+        }
+    }
+
+    count = 0;
+    for (int s = 1; s < goal; s++) {
+        if (index[s] >= 0) {
+            index[s] = count;
+            order[count++] = s;
+        }
+    }
+    return count;
+}
+
+/**
+ * Square sparse matrix in compressed rows; columns are sorted within a row
+ * and every row holds its diagonal entry.
+ */
+typedef struct {
+    int n;
+    int* start;     // Row i holds entries start[i] .. start[i + 1] - 1
+    int* column;
+    double* value;
+    int* diagonal;  // Entry index of (i, i)
+} SparseMatrix;
+
+static void sparse_free(SparseMatrix* m) {
+    free(m->start); free(m->column); free(m->value); free(m->diagonal);
+    memset(m, 0, sizeof(*m));
+}
+
+/**
+ * y = A x, or y = A^T x if `transposed`.
+ */
+static void sparse_multiply(const SparseMatrix* a, bool transposed, const double* x, double* y) {
+    if (transposed) memset(y, 0, (size_t)a->n * sizeof(double));
+    for (int i = 0; i < a->n; i++) {
+        double sum = 0.0;
+        for (int e = a->start[i]; e < a->start[i + 1]; e++) {
+            if (transposed) y[a->column[e]] += a->value[e] * x[i];
+            else sum += a->value[e] * x[a->column[e]];
+        }
+        if (!transposed) y[i] = sum;
+    }
+}
+
+/**
+ * Incomplete LU factorisation without fill-in, in place: the strict lower
+ * part becomes L (unit diagonal), the rest U. `position` is scratch of n
+ * entries. Returns false on a (numerically) zero pivot.
+ */
+static bool ilu_factor(SparseMatrix* a, int* position) {
+    for (int j = 0; j < a->n; j++) position[j] = -1;
+    for (int i = 0; i < a->n; i++) {
+        for (int e = a->start[i]; e < a->start[i + 1]; e++) position[a->column[e]] = e;
+        for (int e = a->start[i]; e < a->diagonal[i]; e++) {
+            int k = a->column[e];
+            double factor = a->value[e] /= a->value[a->diagonal[k]];
+            for (int f = a->diagonal[k] + 1; f < a->start[k + 1]; f++) {
+                int target = position[a->column[f]];
+                if (target >= 0) a->value[target] -= factor * a->value[f];
+            }
+        }
+        for (int e = a->start[i]; e < a->start[i + 1]; e++) position[a->column[e]] = -1;
+        if (fabs(a->value[a->diagonal[i]]) < PIVOT_EPSILON) return false;
+    }
+    return true;
+}
+
+/**
+ * Solves M z = r with the factors M = L U of ilu_factor(), or M^T z = r if
+ * `transposed`; r is overwritten by z.
+ */
+static void ilu_solve(const SparseMatrix* lu, bool transposed, double* r) {
+    int n = lu->n;
+    if (!transposed) {
+        for (int i = 0; i < n; i++) {
+            for (int e = lu->start[i]; e < lu->diagonal[i]; e++) r[i] -= lu->value[e] * r[lu->column[e]];
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            for (int e = lu->diagonal[i] + 1; e < lu->start[i + 1]; e++) r[i] -= lu->value[e] * r[lu->column[e]];
+            r[i] /= lu->value[lu->diagonal[i]];
+        }
+    } else {
+        // M^T = U^T L^T: U^T is lower and L^T upper triangular, both applied by columns
+        for (int i = 0; i < n; i++) {
+            r[i] /= lu->value[lu->diagonal[i]];
+            for (int e = lu->diagonal[i] + 1; e < lu->start[i + 1]; e++) r[lu->column[e]] -= lu->value[e] * r[i];
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            for (int e = lu->start[i]; e < lu->diagonal[i]; e++) r[lu->column[e]] -= lu->value[e] * r[i];
+        }
+    }
+}
+
+static double dot(const double* x, const double* y, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += x[i] * y[i];
+    return sum;
+}
+
+/**
+ * Solves A x = b (A^T x = b if `transposed`) by BiCGSTAB, right-preconditioned
+ * with the incomplete factors `lu` of A; b is overwritten by x. `work` is
+ * scratch of 7 n entries. Returns false if the relative residual does not
+ * drop below SOLVER_TOLERANCE within SOLVER_MAX_ITER steps.
+ */
+static bool sparse_solve(const SparseMatrix* a, const SparseMatrix* lu, bool transposed,
+                         double* b, double* work) {
+    int n = a->n;
+    double *r = work, *r0 = r + n, *p = r0 + n, *v = p + n, *y = v + n, *z = y + n, *t = z + n;
+    double* x = b;
+
+    // Start from the preconditioned right-hand side, usually close already
+    memcpy(r, b, (size_t)n * sizeof(double));
+    double target = SOLVER_TOLERANCE * sqrt(dot(b, b, n));
+    ilu_solve(lu, transposed, x);
+    sparse_multiply(a, transposed, x, t);
+    for (int i = 0; i < n; i++) r[i] -= t[i];
+    memcpy(r0, r, (size_t)n * sizeof(double));
+    memset(p, 0, (size_t)n * sizeof(double));
+    memset(v, 0, (size_t)n * sizeof(double));
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    for (int iter = 0; iter < SOLVER_MAX_ITER; iter++) {
+        if (sqrt(dot(r, r, n)) <= target) return true;
+
+        double rho_next = dot(r0, r, n);
+        if (rho_next == 0.0 || omega == 0.0) return false;  // Breakdown
+        double beta = (rho_next / rho) * (alpha / omega);
+        rho = rho_next;
+        for (int i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+        memcpy(y, p, (size_t)n * sizeof(double));
+        ilu_solve(lu, transposed, y);
+        sparse_multiply(a, transposed, y, v);
+        double denominator = dot(r0, v, n);
+        if (denominator == 0.0) return false;
+        alpha = rho / denominator;
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * y[i];
+            r[i] -= alpha * v[i];  // r is now s
+        }
+        if (sqrt(dot(r, r, n)) <= target) return true;
+
+        memcpy(z, r, (size_t)n * sizeof(double));
+        ilu_solve(lu, transposed, z);
+        sparse_multiply(a, transposed, z, t);
+        double tt = dot(t, t, n);
+        omega = tt > 0.0 ? dot(t, r, n) / tt : 0.0;
+        for (int i = 0; i < n; i++) {
+            x[i] += omega * z[i];
+            r[i] -= omega * t[i];
+        }
+    }
+    return sqrt(dot(r, r, n)) <= target;
+}
+
+/**
+ * Builds A = I - Q over the n transient squares in `order`, merging the faces
+ * that lead to the same square. `a` and `lu` receive the same pattern.
+ * Returns false on allocation failure.
+ */
+static bool build_system(const Graph* graph, const int* index, const int* order, int n,
+                         const double* probabilities, SparseMatrix* a, SparseMatrix* lu) {
+    int faces = graph->die_faces;
+    size_t capacity = (size_t)n * (faces + 1);
+    SparseMatrix* both[2] = { a, lu };
+    for (int m = 0; m < 2; m++) {
+        both[m]->n = n;
+        both[m]->start = malloc((size_t)(n + 1) * sizeof(int));
+        both[m]->column = malloc(capacity * sizeof(int));
+        both[m]->value = malloc(capacity * sizeof(double));
+        both[m]->diagonal = malloc((size_t)n * sizeof(int));
+        if (!both[m]->start || !both[m]->column || !both[m]->value || !both[m]->diagonal) return false;
+    }
+
+    int count = 0;
+    for (int row = 0; row < n; row++) {
+        const int* neighbors = graph_neighbors(graph, order[row]);
+        int first = count;
+        a->start[row] = first;
+        a->column[count] = row;
+        a->value[count++] = 1.0;
+        for (int r = 0; r < faces; r++) {
+            int column = index[neighbors[r]];
+            if (column < 0) continue;
+            int e = first;
+            while (e < count && a->column[e] != column) e++;
+            if (e == count) {
+                a->column[count] = column;
+                a->value[count++] = 0.0;
+            }
+            a->value[e] -= probabilities[r];
+        }
+
+        // Few entries per row: insertion sort by column
+        for (int e = first + 1; e < count; e++) {
+            int column = a->column[e];
+            double value = a->value[e];
+            int f = e;
+            for (; f > first && a->column[f - 1] > column; f--) {
+                a->column[f] = a->column[f - 1];
+                a->value[f] = a->value[f - 1];
+            }
+            a->column[f] = column;
+            a->value[f] = value;
+        }
+        for (int e = first; e < count; e++) {
+            if (a->column[e] == row) a->diagonal[row] = e;
+        }
+    }
+    a->start[n] = count;
+
+    memcpy(lu->start, a->start, (size_t)(n + 1) * sizeof(int));
+    memcpy(lu->column, a->column, (size_t)count * sizeof(int));
+    memcpy(lu->value, a->value, (size_t)count * sizeof(double));
+    memcpy(lu->diagonal, a->diagonal, (size_t)n * sizeof(int));
+    return true;
+}
+
+/**
+ * Checks that the final square can be reached from every transient square
+ * with the faces of positive probability, i.e. that I - Q is invertible.
+ * Returns false if it cannot or on allocation failure (*reason says which).
+ */
+static bool all_reach_goal(const SparseMatrix* a, const Graph* graph, const int* index, const int* order,
+                           const double* probabilities, const char** reason) {
+    int n = a->n, nnz = a->start[n];
+    int* first = calloc((size_t)n + 1, sizeof(int));
+    int* predecessors = malloc((size_t)nnz * sizeof(int));
+    int* queue = malloc((size_t)n * sizeof(int));
+    bool* reaches = malloc((size_t)n * sizeof(bool));
+    if (!first || !predecessors || !queue || !reaches) {
+        free(first); free(predecessors); free(queue); free(reaches);
+        *reason = "out of memory";
+        return false;
+    }
+
+    // Row i moves to column j with positive probability when a[i][j] < 0
+    for (int e = 0; e < nnz; e++) {
+        if (a->value[e] < 0.0) first[a->column[e] + 1]++;
+    }
+    for (int j = 0; j < n; j++) first[j + 1] += first[j];
+    int* fill = queue;  // Borrowed until the search starts
+    memcpy(fill, first, (size_t)n * sizeof(int));
+    for (int row = 0; row < n; row++) {
+        for (int e = a->start[row]; e < a->start[row + 1]; e++) {
+            if (a->value[e] < 0.0) predecessors[fill[a->column[e]]++] = row;
+        }
+    }
+
+    int head = 0, tail = 0;
+    for (int row = 0; row < n; row++) {
+        const int* neighbors = graph_neighbors(graph, order[row]);
+        reaches[row] = false;
+        for (int r = 0; r < graph->die_faces; r++) {
+            if (probabilities[r] > 0.0 && index[neighbors[r]] < 0) reaches[row] = true;
+        }
+        if (reaches[row]) queue[tail++] = row;
+    }
+    while (head < tail) {
+        int column = queue[head++];
+        for (int e = first[column]; e < first[column + 1]; e++) {
+            if (!reaches[predecessors[e]]) {
+                reaches[predecessors[e]] = true;
+                queue[tail++] = predecessors[e];
+            }
+        }
+    }
+
+    free(first); free(predecessors); free(queue); free(reaches);
+    if (tail < n) *reason = "final square is not reached with probability 1";
+    return tail == n;
+}
+
+/**
+ * Builds I - Q over the transient squares, solves the forward and adjoint
+ * systems and derives E and dE/dp; see optimizer.h.
+ */
+bool expected_moves_exact(
+    const Graph* graph,
+    const Board* board,
+    const double* probabilities,
+    double* expected_moves,
+    double* gradient,
+    const char** reason
+) {
+    const char* unused;
+    if (!reason) reason = &unused;
+
+    if (!graph || !graph->neighbors || !board || !probabilities || !expected_moves ||
+        graph->num_nodes != board->size || board->size < 2) {
+        *reason = "invalid parameters";
+        return false;
+    }
+    if (board->rules & RULE_THREE_MAX_HOME) {
+        *reason = "THREE_MAX_HOME is not supported"; // Not a Markov chain on squares
+        return false;
+    }
+
+    int faces = graph->die_faces;
+    int goal = graph->num_nodes;
+    int* index = malloc((size_t)(goal + 1) * sizeof(int));
+    int* order = malloc((size_t)(goal + 1) * sizeof(int));
+    if (!index || !order) {
+        free(index); free(order);
+        *reason = "out of memory";
+        return false;
+    }
+
+    int n = index_transient_squares(graph, index, order);
+    SparseMatrix a = { 0 }, lu = { 0 };
+    int* position = malloc((size_t)n * sizeof(int));
+    double* t = malloc((size_t)n * sizeof(double));
+    double* y = calloc((size_t)n, sizeof(double));
+    double* work = malloc((size_t)n * 7 * sizeof(double));
+    bool ok = position && t && y && work && build_system(graph, index, order, n, probabilities, &a, &lu);
+    if (!ok) *reason = "out of memory";
+
+    ok = ok && all_reach_goal(&a, graph, index, order, probabilities, reason);
+    if (ok) {
+        ok = ilu_factor(&lu, position);
+        if (!ok) *reason = "final square is not reached with probability 1";
+    }
+
+    if (ok) {
+        for (int i = 0; i < n; i++) t[i] = 1.0;
+        ok = sparse_solve(&a, &lu, false, t, work);        // Forward: expected rolls per square
+        if (ok && gradient) {
+            y[index[1]] = 1.0;
+            ok = sparse_solve(&a, &lu, true, y, work);     // Adjoint: expected visits per square
+        }
+        if (!ok) *reason = "iterative solve did not converge";
+    }
+
+    if (ok) {
+        *expected_moves = t[index[1]];
+        if (gradient) {
+            for (int r = 0; r < faces; r++) {
+                double sum = 0.0;
+                for (int row = 0; row < n; row++) {
+                    int column = index[graph_neighbors(graph, order[row])[r]];
+                    if (column >= 0) sum += y[row] * t[column];
+                }
+                gradient[r] = sum;
+            }
+        }
+        ok = isfinite(*expected_moves) && *expected_moves > 0.0;
+        if (!ok) *reason = "final square is not reached with probability 1";
+    }
+
+    sparse_free(&a); sparse_free(&lu);
+    free(index); free(order); free(position); free(t); free(y); free(work);
+    return ok;
+}
+
+/**
+ * Euclidean projection onto { p : sum p = 1, lo <= p_r <= hi }:
+ * p_r = clamp(v_r - shift, lo, hi) with the shift found by bisection.
+ */
+static void project_to_bounds(const double* v, double* p, int faces, double lo, double hi) {
+    // At `low` every face sits at hi (sum >= 1), at `high` every face sits at lo (sum <= 1)
+    double low = v[0] - hi, high = v[0] - lo;
+    for (int r = 1; r < faces; r++) {
+        if (v[r] - hi < low) low = v[r] - hi;
+        if (v[r] - lo > high) high = v[r] - lo;
+    }
+
+    for (int iter = 0; iter < PROJECTION_ITER; iter++) {
+        double shift = 0.5 * (low + high);
+        double sum = 0.0;
+        for (int r = 0; r < faces; r++) sum += fmin(hi, fmax(lo, v[r] - shift));
+        if (sum > 1.0) low = shift;
+        else high = shift;
+    }
+
+    double shift = 0.5 * (low + high);
+    for (int r = 0; r < faces; r++) p[r] = fmin(hi, fmax(lo, v[r] - shift));
+}
+
+/**
+ * Rounds probabilities to positive integer weights summing to
+ * OPTIMIZER_WEIGHT_SCALE (largest remainder first).
+ */
+static void round_to_weights(const double* p, int* weights, int faces) {
+    double remainder[MAX_DIE_FACES];
+    int total = 0;
+    for (int r = 0; r < faces; r++) {
+        double scaled = p[r] * OPTIMIZER_WEIGHT_SCALE;
+        weights[r] = (int)scaled;
+        if (weights[r] < 1) weights[r] = 1;  // The die needs every weight positive
+        remainder[r] = scaled - weights[r];
+        total += weights[r];
+    }
+
+    while (total != OPTIMIZER_WEIGHT_SCALE) {
+        int best = -1;
+        for (int r = 0; r < faces; r++) {
+            if (total < OPTIMIZER_WEIGHT_SCALE) {
+                if (best < 0 || remainder[r] > remainder[best]) best = r;
+            } else if (weights[r] > 1 && (best < 0 || remainder[r] < remainder[best])) {
+                best = r;
+            }
+        }
+        if (best < 0) break;
+        int delta = total < OPTIMIZER_WEIGHT_SCALE ? 1 : -1;
+        weights[best] += delta;
+        remainder[best] -= delta;
+        total += delta;
+    }
+}
+
+/**
+ * Projected gradient descent on (E - target)^2; see optimizer.h.
+ */
+bool optimize_die_weights(
+    const Graph* graph,
+    const Board* board,
+    const int* initial_weights,
+    const OptimizerOptions* options,
+    OptimizerResult* out,
+    const char** reason
+) {
+    const char* unused;
+    if (!reason) reason = &unused;
+
+    if (!graph || !board || !options || !out) {
+        *reason = "invalid parameters";
+        return false;
+    }
+
+    int faces = graph->die_faces;
+    double lo = options->min_probability, hi = options->max_probability;
+    if (faces <= 0 || faces > MAX_DIE_FACES || options->target_moves <= 0.0) {
+        *reason = "invalid die or target";
+        return false;
+    }
+    if (lo <= 0.0 || hi > 1.0 || lo > hi || lo * faces > 1.0 || hi * faces < 1.0) {
+        *reason = "probability bounds admit no die";
+        return false;
+    }
+    if (initial_weights && !dice_validate_probabilities(initial_weights, faces)) {
+        *reason = "invalid initial weights";
+        return false;
+    }
+
+    int max_iterations = options->max_iterations > 0 ? options->max_iterations : OPTIMIZER_MAX_ITERATIONS;
+    double tolerance = options->tolerance > 0.0 ? options->tolerance : OPTIMIZER_TOLERANCE;
+
+    memset(out, 0, sizeof(*out));
+
+    double start[MAX_DIE_FACES], p[MAX_DIE_FACES], candidate[MAX_DIE_FACES], v[MAX_DIE_FACES];
+    double total_weight = 0.0;
+    for (int r = 0; r < faces; r++) {
+        start[r] = initial_weights ? initial_weights[r] : 1.0;
+        total_weight += start[r];
+    }
+    for (int r = 0; r < faces; r++) start[r] /= total_weight;
+    project_to_bounds(start, p, faces, lo, hi);
+
+    double expected, gradient[MAX_DIE_FACES];
+    if (!expected_moves_exact(graph, board, p, &expected, gradient, reason)) return false;
+
+    double error = expected - options->target_moves;
+    double step = 1e-3;  // In probability units per unit of gradient; adapted below
+    int iteration = 0;
+
+    // Scale the first step so that it moves p by about 1%. Only the part of the
+    // gradient along the simplex counts: the projection removes its mean.
+    double mean = 0.0, norm = 0.0;
+    for (int r = 0; r < faces; r++) mean += gradient[r] / faces;
+    for (int r = 0; r < faces; r++) norm += (gradient[r] - mean) * (gradient[r] - mean);
+    if (norm > 0.0 && error != 0.0) step = 0.01 / (2.0 * fabs(error) * sqrt(norm));
+
+    while (fabs(error) > tolerance && iteration < max_iterations && step > MIN_STEP) {
+        iteration++;
+
+        for (int r = 0; r < faces; r++) v[r] = p[r] - step * 2.0 * error * gradient[r];
+        project_to_bounds(v, candidate, faces, lo, hi);
+
+        double candidate_expected, candidate_gradient[MAX_DIE_FACES];
+        bool solved = expected_moves_exact(graph, board, candidate, &candidate_expected, candidate_gradient, NULL);
+        double candidate_error = solved ? candidate_expected - options->target_moves : INFINITY;
+
+        if (fabs(candidate_error) < fabs(error)) {
+            memcpy(p, candidate, sizeof(p));
+            memcpy(gradient, candidate_gradient, sizeof(gradient));
+            expected = candidate_expected;
+            error = candidate_error;
+            step *= 2.0;   // Accepted: try a longer step next time
+        } else {
+            step *= 0.25;  // Rejected (overshoot or leaving the feasible chain)
+        }
+    }
+
+    memcpy(out->probabilities, p, sizeof(double) * faces);
+    memcpy(out->gradient, gradient, sizeof(double) * faces);
+    out->expected_moves = expected;
+    out->iterations = iteration;
+    out->converged = fabs(error) <= tolerance;
+
+    round_to_weights(p, out->weights, faces);
+    double rounded[MAX_DIE_FACES];
+    for (int r = 0; r < faces; r++) rounded[r] = (double)out->weights[r] / OPTIMIZER_WEIGHT_SCALE;
+    if (!expected_moves_exact(graph, board, rounded, &out->weighted_expected_moves, NULL, NULL)) {
+        out->weighted_expected_moves = expected;
+    }
+    return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "board.h"
+#include "dice.h"
+#include "graph.h"
+#include <stdbool.h>
+
+#define OPTIMIZER_WEIGHT_SCALE    1000  // Integer die weights returned sum to this
+#define OPTIMIZER_MAX_ITERATIONS  500   // Default iteration limit
+#define OPTIMIZER_TOLERANCE       1e-3  // Default |E - target| accepted as converged
+
+/**
+ * Constraints and stopping rules for optimize_die_weights().
+ */
+typedef struct {
+    double target_moves;      // Desired expected number of rolls to win
+    double min_probability;   // Lower bound for every face probability (> 0)
+    double max_probability;   // Upper bound for every face probability (<= 1)
+    int max_iterations;       // Projected-gradient steps before giving up
+    double tolerance;         // Stop once |E - target| is below this
+} OptimizerOptions;
+
+/**
+ * Outcome of a die-weight optimisation.
+ */
+typedef struct {
+    double probabilities[MAX_DIE_FACES];  // Best face probabilities found
+    int weights[MAX_DIE_FACES];           // The same as integer weights (sum OPTIMIZER_WEIGHT_SCALE)
+    double expected_moves;                // Exact E[rolls] with `probabilities`
+    double weighted_expected_moves;       // Exact E[rolls] with the rounded `weights`
+    double gradient[MAX_DIE_FACES];       // dE/dp_r at `probabilities` (not projected onto the simplex)
+    int iterations;                       // Steps taken
+    bool converged;                       // |E - target| <= tolerance
+} OptimizerResult;
+
+/**
+ * Computes the exact expected number of rolls to win from square 1 and its
+ * gradient with respect to each face probability, from the absorbing Markov
+ * chain of the board graph.
+ *
+ * With Q the transitions between the squares reachable from square 1 (the
+ * final square is absorbing), the expected rolls t solve (I - Q) t = 1 and
+ * E = t[1]. The adjoint y solves (I - Q)^T y = e_1, and since p_r enters Q
+ * once per square (edge s -> dest(s, r)), dE/dp_r = sum_s y[s] * t[dest(s, r)].
+ *
+ * I - Q has at most die_faces + 1 entries per row. Both systems are solved by
+ * BiCGSTAB, preconditioned with one incomplete LU factorisation (no fill-in)
+ * of I - Q in board order, which is exact but for the backward jumps. Memory
+ * is linear in the number of reachable squares. One call takes tens of
+ * milliseconds on a 100x100 board and a few seconds on a 300x300 board with
+ * long games; optimize_die_weights() makes one call per iteration.
+ *
+ * Games are not capped at simulate_move_cap() here, so E is slightly above the
+ * simulated average on boards where many games hit the cap.
+ *
+ * @param graph Graph built with graph_build() for the board and die.
+ * @param board Pointer to the board (RULE_THREE_MAX_HOME is not supported).
+ * @param probabilities Face probabilities (die_faces = graph->die_faces entries, summing to 1).
+ * @param expected_moves Output: E[rolls to win].
+ * @param gradient Optional output: dE/dp_r per face (may be NULL).
+ * @param reason Optional output: why it failed (may be NULL).
+ * @return true on success, false if the rules are not supported, the final
+ *         square cannot be reached with probability 1, the iterative solve
+ *         does not converge, or on allocation failure.
+ */
+bool expected_moves_exact(
+    const Graph* graph,
+    const Board* board,
+    const double* probabilities,
+    double* expected_moves,
+    double* gradient,
+    const char** reason
+);
+
+/**
+ * Finds die face probabilities that make the exact expected game length
+ * hit `options->target_moves`, within per-face bounds.
+ *
+ * Minimises (E(p) - target)^2 by projected gradient descent with an adaptive
+ * step: each step moves against the adjoint gradient and projects back onto
+ * the simplex intersected with [min_probability, max_probability]. If the
+ * target cannot be reached within the bounds, the closest feasible die is
+ * returned with converged = false.
+ *
+ * @param graph Graph built with graph_build() for the board and die.
+ * @param board Pointer to the board (RULE_THREE_MAX_HOME is not supported).
+ * @param initial_weights Starting weights (graph->die_faces entries), or NULL for a fair die.
+ * @param options Target, bounds and stopping rules.
+ * @param out Output structure for the result.
+ * @param reason Optional output: why it failed (may be NULL).
+ * @return true if the optimisation ran, false on invalid parameters,
+ *         infeasible bounds or a board expected_moves_exact() cannot solve.
+ */
+bool optimize_die_weights(
+    const Graph* graph,
+    const Board* board,
+    const int* initial_weights,
+    const OptimizerOptions* options,
+    OptimizerResult* out,
+    const char** reason
+);
@@ -0,0 +1,449 @@
+#define _POSIX_C_SOURCE 200809L  // for clock_gettime()
+
+#include "pipeline.h"
+#include "dice.h"
+#include "timing.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CACHE_LINE          64
+#define RING_MASK           (PIPELINE_RING_CAPACITY - 1)
+#define GAMES_OUT_BUFFER    (64 * 1024)  // Per-aggregator text buffer for per-game output
+#define RECORD_INLINE_MOVES MOVE_CAP_MIN  // Rolls stored in the ring slot itself
+
+// Longest per-game line for a game of `moves` rolls: "won count" plus " roll" each
+#define GAMES_OUT_LINE_LENGTH(moves) (16 + (size_t)(moves) * 3)
+
+_Static_assert((PIPELINE_RING_CAPACITY & RING_MASK) == 0, "ring capacity must be a power of two");
+_Static_assert(MAX_DIE_FACES < 100, "rolls must fit two digits of per-game output");
+
+/**
+ * Compact form of a GameResult as it travels through a ring. Games of up to
+ * RECORD_INLINE_MOVES rolls (all games on boards up to 10x10) travel inside
+ * the slot; the rolls of longer games are copied to the heap by the worker
+ * and freed by the aggregator that consumes the record.
+ */
+typedef struct {
+    uint32_t move_count;
+    uint32_t turn_count;
+    uint8_t won;
+    uint8_t die_faces;
+    uint8_t* overflow;   // Rolls of a game longer than RECORD_INLINE_MOVES, else NULL
+    uint8_t moves[RECORD_INLINE_MOVES];
+} GameRecord;
+
+/**
+ * Single-producer/single-consumer ring. The producer only writes `tail`,
+ * the consumer only writes `head`; both live on their own cache line so
+ * the two threads do not invalidate each other's line on every record.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_size_t tail;  // Next slot the producer fills
+    atomic_bool finished;                     // Producer has pushed its last record
+    _Alignas(CACHE_LINE) atomic_size_t head;  // Next slot the consumer reads
+    _Alignas(CACHE_LINE) GameRecord slots[PIPELINE_RING_CAPACITY];
+} RecordRing;
+
+typedef struct {
+    const Board* board;
+    int die_faces;
+    bool use_non_uniform;
+    const int* probabilities;
+    uint64_t num_games;
+    uint64_t seed;
+    RecordRing* ring;
+    uint64_t* occupancy;   // This worker's landing counters, or NULL
+    uint64_t stalls;
+    bool failed;           // Out of memory for a long game; stopped early
+    struct timespec finished_at;
+} Worker;
+
+typedef struct {
+    const Board* board;
+    RecordRing** rings;
+    int num_rings;
+    int first_ring;       // Rings first_ring, first_ring + stride, ... belong to this aggregator
+    int stride;
+    FILE* games_out;
+    pthread_mutex_t* games_out_lock;
+    Progress* progress;
+
+    uint64_t games;
+    uint64_t wins;
+    uint64_t total_moves;
+    uint64_t total_turns;
+    Stats stats;
+    GameResult shortest;
+    bool found_win;
+    GameResult scratch;   // Record being consumed
+    double busy_seconds;
+    uint64_t idle;
+    bool failed;          // Out of memory; stopped draining
+} Aggregator;
+
+static void* worker_main(void* arg) {
+    Worker* worker = arg;
+    RecordRing* ring = worker->ring;
+
+    DiceRng rng;
+    dice_rng_seed(&rng, worker->seed);
+
+    size_t tail = 0;
+    size_t cached_head = 0;  // Last head seen; refreshed only when the ring looks full
+    GameResult result;
+    worker->failed = !game_result_init(&result, worker->board);
+
+    for (uint64_t g = 0; g < worker->num_games && !worker->failed; g++) {
+        simulate_game_counted(worker->board, worker->die_faces, &result,
+                              worker->use_non_uniform, worker->probabilities, &rng,
+                              worker->occupancy);
+
+        while (tail - cached_head == PIPELINE_RING_CAPACITY) {
+            cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (tail - cached_head == PIPELINE_RING_CAPACITY) {
+                worker->stalls++;
+                sched_yield();
+            }
+        }
+
+        GameRecord* record = &ring->slots[tail & RING_MASK];
+        record->move_count = (uint32_t)result.move_count;
+        record->turn_count = (uint32_t)result.turn_count;
+        record->won = result.won;
+        record->die_faces = (uint8_t)result.die_faces;
+        record->overflow = NULL;
+        if (result.move_count <= RECORD_INLINE_MOVES) {
+            memcpy(record->moves, result.moves, (size_t)result.move_count);
+        } else {
+            record->overflow = malloc((size_t)result.move_count);
+            if (!record->overflow) {
+                worker->failed = true;
+                break;
+            }
+            memcpy(record->overflow, result.moves, (size_t)result.move_count);
+        }
+
+        tail++;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    game_result_free(&result);
+    atomic_store_explicit(&ring->finished, true, memory_order_release);
+    clock_gettime(CLOCK_MONOTONIC, &worker->finished_at);
+    return NULL;
+}
+
+/**
+ * Writes buffered per-game lines to the shared output.
+ */
+static void flush_games_out(Aggregator* aggregator, char* buffer, size_t* used) {
+    if (*used == 0) return;
+    pthread_mutex_lock(aggregator->games_out_lock);
+    fwrite(buffer, 1, *used, aggregator->games_out);
+    pthread_mutex_unlock(aggregator->games_out_lock);
+    *used = 0;
+}
+
+/**
+ * Appends the per-game line of one game to the buffer. Lines too long for
+ * the buffer (very long games on large boards) are written straight through.
+ */
+static void write_game_line(Aggregator* aggregator, const GameResult* game, char* buffer, size_t* used) {
+    if (*used + GAMES_OUT_LINE_LENGTH(game->move_count) > GAMES_OUT_BUFFER) {
+        flush_games_out(aggregator, buffer, used);
+    }
+
+    if (GAMES_OUT_LINE_LENGTH(game->move_count) > GAMES_OUT_BUFFER) {
+        pthread_mutex_lock(aggregator->games_out_lock);
+        fprintf(aggregator->games_out, "%d %d", game->won ? 1 : 0, game->move_count);
+        for (int i = 0; i < game->move_count; i++) {
+            fprintf(aggregator->games_out, " %d", game->moves[i]);
+        }
+        fputc('\n', aggregator->games_out);
+        pthread_mutex_unlock(aggregator->games_out_lock);
+        return;
+    }
+
+    *used += (size_t)sprintf(buffer + *used, "%d %d", game->won ? 1 : 0, game->move_count);
+    for (int i = 0; i < game->move_count; i++) {
+        *used += (size_t)sprintf(buffer + *used, " %d", game->moves[i]);
+    }
+    buffer[(*used)++] = '\n';
+}
+
+/**
+ * Folds one record into the aggregator's totals and releases its overflow rolls.
+ */
+static void consume_record(Aggregator* aggregator, GameRecord* record,
+                           GameResult* scratch, char* buffer, size_t* used) {
+    scratch->move_count = (int)record->move_count;
+    scratch->turn_count = (int)record->turn_count;
+    scratch->won = record->won;
+    scratch->die_faces = record->die_faces;
+    memcpy(scratch->moves, record->overflow ? record->overflow : record->moves, record->move_count);
+    free(record->overflow);
+    record->overflow = NULL;
+
+    aggregator->games++;
+    if (scratch->won) {
+        aggregator->wins++;
+        aggregator->total_moves += scratch->move_count;
+        aggregator->total_turns += scratch->turn_count;
+        if (!aggregator->found_win || scratch->move_count < aggregator->shortest.move_count) {
+            game_result_copy(&aggregator->shortest, scratch);
+            aggregator->found_win = true;
+        }
+        stats_update(aggregator->board, scratch, &aggregator->stats);
+    }
+
+    if (aggregator->games_out) write_game_line(aggregator, scratch, buffer, used);
+}
+
+static void* aggregator_main(void* arg) {
+    Aggregator* aggregator = arg;
+    char* buffer = aggregator->games_out ? malloc(GAMES_OUT_BUFFER) : NULL;
+    size_t used = 0;
+    if (aggregator->games_out && !buffer) aggregator->games_out = NULL;
+
+    bool* drained = calloc(aggregator->num_rings, sizeof(bool));
+    int active = 0;
+    for (int r = aggregator->first_ring; r < aggregator->num_rings; r += aggregator->stride) {
+        active++;
+    }
+
+    while (active > 0 && drained) {
+        bool progressed = false;
+
+        for (int r = aggregator->first_ring; r < aggregator->num_rings; r += aggregator->stride) {
+            if (drained[r]) continue;
+            RecordRing* ring = aggregator->rings[r];
+
+            // Read `finished` before `tail`: once finished, the tail seen is final
+            bool finished = atomic_load_explicit(&ring->finished, memory_order_acquire);
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+            size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+            size_t available = tail - head;
+            if (available == 0) {
+                if (finished) {
+                    drained[r] = true;
+                    active--;
+                }
+                continue;
+            }
+            if (available > PIPELINE_BATCH) available = PIPELINE_BATCH;
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            uint64_t wins_before = aggregator->wins;
+            uint64_t moves_before = aggregator->total_moves;
+            for (size_t i = 0; i < available; i++) {
+                consume_record(aggregator, &ring->slots[(head + i) & RING_MASK], &aggregator->scratch,
+                               buffer, &used);
+            }
+            atomic_store_explicit(&ring->head, head + available, memory_order_release);
+            progress_add(aggregator->progress, available, aggregator->wins - wins_before,
+                         aggregator->total_moves - moves_before);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            aggregator->busy_seconds += timing_seconds_between(&start, &end);
+            progressed = true;
+        }
+
+        if (!progressed && active > 0) {
+            aggregator->idle++;
+            sched_yield();
+        }
+    }
+
+    if (!drained) aggregator->failed = true;
+    if (buffer) flush_games_out(aggregator, buffer, &used);
+    free(buffer);
+    free(drained);
+    return NULL;
+}
+
+/**
+ * Runs the simulation and aggregation stages; see pipeline.h.
+ */
+bool pipeline_run(
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    uint64_t num_games,
+    const PipelineOptions* options,
+    PipelineReport* out
+) {
+    if (!board || !options || !out || num_games == 0) return false;
+    if (die_faces <= 0 || die_faces > MAX_DIE_FACES) return false;
+    if (options->num_workers <= 0 || options->num_aggregators <= 0) return false;
+
+    int num_workers = options->num_workers;
+    int num_aggregators = options->num_aggregators < num_workers ? options->num_aggregators : num_workers;
+
+    RecordRing** rings = calloc(num_workers, sizeof(RecordRing*));
+    Worker* workers = calloc(num_workers, sizeof(Worker));
+    Aggregator* aggregators = calloc(num_aggregators, sizeof(Aggregator));
+    pthread_t* threads = calloc(num_workers + num_aggregators, sizeof(pthread_t));
+    bool ok = rings && workers && aggregators && threads;
+
+    for (int i = 0; ok && i < num_workers; i++) {
+        rings[i] = aligned_alloc(CACHE_LINE, sizeof(RecordRing));
+        if (!rings[i]) {
+            ok = false;
+            break;
+        }
+        atomic_init(&rings[i]->tail, 0);
+        atomic_init(&rings[i]->head, 0);
+        atomic_init(&rings[i]->finished, false);
+    }
+
+    pthread_mutex_t games_out_lock = PTHREAD_MUTEX_INITIALIZER;
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    int launched = 0;
+
+    if (ok) {
+        for (int i = 0; i < num_workers; i++) {
+            Worker* worker = &workers[i];
+            worker->board = board;
+            worker->die_faces = die_faces;
+            worker->use_non_uniform = use_non_uniform;
+            worker->probabilities = probabilities;
+            worker->num_games = num_games / num_workers + ((uint64_t)i < num_games % num_workers ? 1 : 0);
+            worker->seed = options->seed + (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+            worker->ring = rings[i];
+            worker->finished_at = started;
+            if (options->heatmap) {
+                worker->occupancy = heatmap_thread_counters(options->heatmap);
+                if (!worker->occupancy) ok = false;
+            }
+        }
+        for (int a = 0; a < num_aggregators; a++) {
+            Aggregator* aggregator = &aggregators[a];
+            aggregator->board = board;
+            aggregator->rings = rings;
+            aggregator->num_rings = num_workers;
+            aggregator->first_ring = a;
+            aggregator->stride = num_aggregators;
+            aggregator->games_out = options->games_out;
+            aggregator->games_out_lock = &games_out_lock;
+            aggregator->progress = options->progress;
+            if (!stats_init(&aggregator->stats, board) ||
+                !game_result_init(&aggregator->shortest, board) ||
+                !game_result_init(&aggregator->scratch, board)) ok = false;
+        }
+
+        // Consumers first, so rings start draining as soon as workers produce
+        for (int a = 0; a < num_aggregators && ok; a++) {
+            ok = pthread_create(&threads[launched], NULL, aggregator_main, &aggregators[a]) == 0;
+            if (ok) launched++;
+        }
+        for (int i = 0; i < num_workers && ok; i++) {
+            ok = pthread_create(&threads[launched], NULL, worker_main, &workers[i]) == 0;
+            if (ok) launched++;
+        }
+
+        if (!ok) {
+            // Let aggregators exit: mark rings of workers that never started as finished
+            for (int i = launched - num_aggregators; i < num_workers; i++) {
+                if (i >= 0) atomic_store(&rings[i]->finished, true);
+            }
+        }
+        for (int t = 0; t < launched; t++) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+
+    for (int i = 0; ok && i < num_workers; i++) {
+        if (workers[i].failed) ok = false;
+    }
+    for (int a = 0; ok && a < num_aggregators; a++) {
+        if (aggregators[a].failed) ok = false;
+    }
+
+    if (ok) {
+        struct timespec ended;
+        clock_gettime(CLOCK_MONOTONIC, &ended);
+
+        memset(out, 0, sizeof(*out));
+        ok = stats_init(&out->stats, board) && game_result_init(&out->shortest, board);
+        out->wall_seconds = timing_seconds_between(&started, &ended);
+
+        for (int i = 0; i < num_workers; i++) {
+            double produced = timing_seconds_between(&started, &workers[i].finished_at);
+            if (produced > out->simulate_seconds) out->simulate_seconds = produced;
+            out->producer_stalls += workers[i].stalls;
+            if (options->heatmap) heatmap_merge(options->heatmap, workers[i].occupancy, workers[i].num_games);
+        }
+        for (int a = 0; a < num_aggregators; a++) {
+            Aggregator* aggregator = &aggregators[a];
+            out->games += aggregator->games;
+            out->wins += aggregator->wins;
+            out->total_moves += aggregator->total_moves;
+            out->total_turns += aggregator->total_turns;
+            out->aggregate_seconds += aggregator->busy_seconds;
+            out->consumer_idle += aggregator->idle;
+            stats_merge(&out->stats, &aggregator->stats);
+            if (aggregator->found_win &&
+                (!out->found_win || aggregator->shortest.move_count < out->shortest.move_count)) {
+                game_result_copy(&out->shortest, &aggregator->shortest);
+                out->found_win = true;
+            }
+        }
+        if (!ok) pipeline_report_free(out);
+    }
+
+    for (int a = 0; aggregators && a < num_aggregators; a++) {
+        stats_free(&aggregators[a].stats);
+        game_result_free(&aggregators[a].shortest);
+        game_result_free(&aggregators[a].scratch);
+    }
+    for (int i = 0; rings && i < num_workers; i++) {
+        // Records left behind by a failed run may still own overflow rolls
+        size_t head = rings[i] ? atomic_load(&rings[i]->head) : 0;
+        size_t tail = rings[i] ? atomic_load(&rings[i]->tail) : 0;
+        for (; head != tail; head++) {
+            free(rings[i]->slots[head & RING_MASK].overflow);
+        }
+        free(rings[i]);
+    }
+    for (int i = 0; workers && i < num_workers; i++) {
+        free(workers[i].occupancy);
+    }
+    free(rings);
+    free(workers);
+    free(aggregators);
+    free(threads);
+    return ok;
+}
+
+/**
+ * Releases the statistics and shortest game held by a report.
+ */
+void pipeline_report_free(PipelineReport* report) {
+    if (!report) return;
+    stats_free(&report->stats);
+    game_result_free(&report->shortest);
+}
+
+/**
+ * Prints games per second for each stage and how often each side waited.
+ */
+void pipeline_print_report(const PipelineReport* report) {
+    if (!report) return;
+
+    double sim_rate = report->simulate_seconds > 0 ? report->games / report->simulate_seconds : 0.0;
+    double agg_rate = report->aggregate_seconds > 0 ? report->games / report->aggregate_seconds : 0.0;
+
+    printf("\n⚙️ Pipeline throughput (%.3f s wall):\n", report->wall_seconds);
+    printf("  Simulation:  %12.0f games/s  (%llu stalls on full rings)\n",
+           sim_rate, (unsigned long long)report->producer_stalls);
+    printf("  Aggregation: %12.0f games/s per busy thread  (%llu idle polls)\n",
+           agg_rate, (unsigned long long)report->consumer_idle);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "board.h"
+#include "heatmap.h"
+#include "progress.h"
+#include "simulator.h"
+#include "stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PIPELINE_RING_CAPACITY 1024  // Records per worker ring (power of two)
+#define PIPELINE_BATCH         256   // Records an aggregator drains per visit
+
+/**
+ * Settings for a pipelined simulation run.
+ */
+typedef struct {
+    int num_workers;       // Simulation threads (one ring each)
+    int num_aggregators;   // Aggregation threads draining the rings
+    uint64_t seed;         // Base seed; worker i uses a stream derived from seed and i
+    FILE* games_out;       // Optional per-game output (one line per game), or NULL
+    Heatmap* heatmap;      // Optional landing counts (initialized by the caller), or NULL
+    Progress* progress;    // Optional progress reporter (started by the caller), or NULL
+} PipelineOptions;
+
+/**
+ * Aggregated results and per-stage throughput of a pipelined run.
+ */
+typedef struct {
+    uint64_t games;              // Games simulated
+    uint64_t wins;               // Games that reached the final square
+    uint64_t total_moves;        // Sum of moves over won games
+    uint64_t total_turns;        // Sum of turns over won games (differs under RULE_REROLL_ON_MAX)
+    Stats stats;                 // Snake and ladder usage (won games)
+    GameResult shortest;         // Shortest winning game
+    bool found_win;              // true if `shortest` holds a game
+
+    double wall_seconds;         // Whole run
+    double simulate_seconds;     // Until the last worker finished producing
+    double aggregate_seconds;    // Summed busy time of the aggregators
+    uint64_t producer_stalls;    // Times a worker found its ring full (backpressure)
+    uint64_t consumer_idle;      // Times an aggregator found all its rings empty
+} PipelineReport;
+
+/**
+ * Simulates `num_games` games on several threads and aggregates them on others.
+ *
+ * Simulation workers pack each game into a compact record and push it into
+ * their own lock-free single-producer/single-consumer ring. Aggregator
+ * threads drain the rings in batches and update averages, shortest game,
+ * Stats and the optional per-game output. A worker whose ring is full waits
+ * (backpressure) instead of dropping games; a slow consumer therefore only
+ * throttles the workers that feed it once its ring has filled up.
+ * With options->heatmap set, each worker also counts landings into its own
+ * cache-line-padded counters, which are merged into the heatmap at the end.
+ * With options->progress set, aggregators report once per drained batch.
+ *
+ * @param board Pointer to the game board.
+ * @param die_faces Number of die faces.
+ * @param use_non_uniform Use weighted die if true.
+ * @param probabilities Weights for non-uniform die (if enabled).
+ * @param num_games Number of games to simulate.
+ * @param options Thread counts, seed and optional per-game output.
+ * @param out Output structure for the results and throughput figures;
+ *            on success release it with pipeline_report_free().
+ * @return true on success, false on invalid parameters or thread/allocation failure.
+ */
+bool pipeline_run(
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    uint64_t num_games,
+    const PipelineOptions* options,
+    PipelineReport* out
+);
+
+/**
+ * Releases the statistics and shortest game held by a report.
+ * Safe to call on a zeroed or already freed report.
+ *
+ * @param report Pointer to the report filled by pipeline_run().
+ */
+void pipeline_report_free(PipelineReport* report);
+
+/**
+ * Prints the per-stage throughput of a pipelined run.
+ *
+ * @param report Pointer to the report filled by pipeline_run().
+ */
+void pipeline_print_report(const PipelineReport* report);
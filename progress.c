@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 200809L  // for clock_gettime()
+
+#include "progress.h"
+#include "timing.h"
+#include <string.h>
+
+/**
+ * Formats a duration as h:mm:ss.
+ */
+static void format_duration(double seconds, char* buffer, size_t size) {
+    if (seconds < 0.0 || seconds > 1e9) {
+        snprintf(buffer, size, "?");
+        return;
+    }
+    unsigned long long total = (unsigned long long)(seconds + 0.5);
+    snprintf(buffer, size, "%llu:%02llu:%02llu", total / 3600, total / 60 % 60, total % 60);
+}
+
+/**
+ * Prints one report line from the current counters.
+ */
+static void report(Progress* progress) {
+    uint64_t games = atomic_load_explicit(&progress->games, memory_order_relaxed);
+    uint64_t wins = atomic_load_explicit(&progress->wins, memory_order_relaxed);
+    uint64_t total_moves = atomic_load_explicit(&progress->total_moves, memory_order_relaxed);
+
+    double elapsed = timing_seconds_since(&progress->started);
+    double rate = elapsed > 0.0 ? games / elapsed : 0.0;
+    double percent = progress->total_games ? 100.0 * games / progress->total_games : 0.0;
+    double avg = wins ? (double)total_moves / wins : 0.0;
+
+    char eta[32];
+    if (games >= progress->total_games) snprintf(eta, sizeof(eta), "done");
+    else format_duration(rate > 0.0 ? (progress->total_games - games) / rate : -1.0, eta, sizeof(eta));
+
+    fprintf(progress->out, "⏳ %5.1f%%  %llu/%llu games  %.3g games/s  avg %.4f  ETA %s\n",
+            percent, (unsigned long long)games, (unsigned long long)progress->total_games,
+            rate, avg, eta);
+    fflush(progress->out);
+}
+
+static void* reporter_main(void* arg) {
+    Progress* progress = arg;
+
+    pthread_mutex_lock(&progress->lock);
+    while (!progress->stopping) {
+        // Sleep on the condition variable so progress_stop() wakes us at once
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        double whole = (double)(long)progress->interval_seconds;
+        deadline.tv_sec += (time_t)whole;
+        deadline.tv_nsec += (long)((progress->interval_seconds - whole) * 1e9);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_cond_timedwait(&progress->wake, &progress->lock, &deadline);
+        if (!progress->stopping) report(progress);
+    }
+    pthread_mutex_unlock(&progress->lock);
+    return NULL;
+}
+
+/**
+ * Resets the counters and launches the reporter thread.
+ */
+bool progress_start(Progress* progress, uint64_t total_games, double interval_seconds, FILE* out) {
+    if (!progress || !out || interval_seconds <= 0.0) return false;
+
+    memset(progress, 0, sizeof(*progress));
+    atomic_init(&progress->games, 0);
+    atomic_init(&progress->wins, 0);
+    atomic_init(&progress->total_moves, 0);
+    progress->total_games = total_games;
+    progress->interval_seconds = interval_seconds;
+    progress->out = out;
+    clock_gettime(CLOCK_MONOTONIC, &progress->started);
+    pthread_mutex_init(&progress->lock, NULL);
+    pthread_cond_init(&progress->wake, NULL);
+
+    progress->running = pthread_create(&progress->thread, NULL, reporter_main, progress) == 0;
+    if (!progress->running) {
+        pthread_mutex_destroy(&progress->lock);
+        pthread_cond_destroy(&progress->wake);
+    }
+    return progress->running;
+}
+
+/**
+ * Wakes and joins the reporter, then prints the final state.
+ */
+void progress_stop(Progress* progress) {
+    if (!progress || !progress->running) return;
+
+    pthread_mutex_lock(&progress->lock);
+    progress->stopping = true;
+    pthread_cond_signal(&progress->wake);
+    pthread_mutex_unlock(&progress->lock);
+    pthread_join(progress->thread, NULL);
+
+    report(progress);
+    pthread_mutex_destroy(&progress->lock);
+    pthread_cond_destroy(&progress->wake);
+    progress->running = false;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define PROGRESS_CHUNK_GAMES 65536  // Games a simulation loop runs between two progress_add() calls
+
+/**
+ * Shared progress of a long simulation run, with a background thread that
+ * periodically prints games done, throughput, the current average and an ETA.
+ *
+ * Simulation threads never touch it per game: they accumulate locally and
+ * call progress_add() once per chunk of games (a few relaxed atomic adds).
+ */
+typedef struct {
+    atomic_uint_least64_t games;        // Games finished so far
+    atomic_uint_least64_t wins;         // Won games so far
+    atomic_uint_least64_t total_moves;  // Sum of moves over won games so far
+    uint64_t total_games;               // Games expected in the whole run
+
+    double interval_seconds;            // Time between two report lines
+    FILE* out;                          // Where report lines go
+    struct timespec started;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+    bool running;
+} Progress;
+
+/**
+ * Starts the reporter thread. Stop it with progress_stop().
+ *
+ * @param progress Pointer to the progress state to initialize.
+ * @param total_games Number of games the run will simulate (for the ETA).
+ * @param interval_seconds Seconds between report lines (> 0).
+ * @param out Stream for the report lines (e.g. stderr).
+ * @return true if the reporter is running, false on invalid parameters or thread failure.
+ */
+bool progress_start(Progress* progress, uint64_t total_games, double interval_seconds, FILE* out);
+
+/**
+ * Records a finished chunk of games. Safe to call from any thread;
+ * a NULL progress is ignored so callers need no extra branch.
+ *
+ * @param progress Progress state, or NULL.
+ * @param games Games in the chunk.
+ * @param wins Won games in the chunk.
+ * @param total_moves Sum of moves over the chunk's won games.
+ */
+static inline void progress_add(Progress* progress, uint64_t games, uint64_t wins, uint64_t total_moves) {
+    if (!progress) return;
+
+    atomic_fetch_add_explicit(&progress->games, games, memory_order_relaxed);
+    atomic_fetch_add_explicit(&progress->wins, wins, memory_order_relaxed);
+    atomic_fetch_add_explicit(&progress->total_moves, total_moves, memory_order_relaxed);
+}
+
+/**
+ * Stops the reporter thread after printing a final line, and releases it.
+ *
+ * @param progress Progress state started with progress_start().
+ */
+void progress_stop(Progress* progress);
@@ -0,0 +1,395 @@
+#include "rare.h"
+#include "dice.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAIL_SPLIT_MAX_PARTICLES     (1u << 22)  // Games one splitting run tracks at once
+#define TAIL_SPLIT_RESAMPLE_FRACTION 0.5         // Refill once fewer than this share of games still run
+
+/**
+ * Precomputed per-square sampling tables for one tilt factor.
+ * Entries are indexed by square * die_faces + (roll - 1).
+ */
+typedef struct {
+    int* dest;           // Square reached after the roll (jumps and overshoot applied)
+    double* cumulative;  // Cumulative tilted roll distribution q(r | square)
+    double* log_ratio;   // log(p(r) / q(r | square))
+    int die_faces;
+} TiltTables;
+
+/**
+ * Accumulated likelihood-ratio weights of the games that hit the tail event.
+ */
+typedef struct {
+    double sum_w;
+    double sum_w2;
+    uint64_t hits;
+} TailSums;
+
+static void tilt_tables_free(TiltTables* tables) {
+    free(tables->dest);
+    free(tables->cumulative);
+    free(tables->log_ratio);
+}
+
+/**
+ * Builds the tilted roll distribution for every square.
+ * Rolls that delay the player (snake head, overshoot) get `bias` times the
+ * nominal weight, rolls that advance it (ladder, winning roll) get 1 / `bias`.
+ */
+static bool tilt_tables_build(TiltTables* tables, const Board* board,
+                              int die_faces, const double* p, double bias) {
+    size_t entries = (size_t)(board->size + 1) * die_faces;
+    tables->die_faces = die_faces;
+    tables->dest = malloc(entries * sizeof(int));
+    tables->cumulative = malloc(entries * sizeof(double));
+    tables->log_ratio = malloc(entries * sizeof(double));
+    if (!tables->dest || !tables->cumulative || !tables->log_ratio) {
+        tilt_tables_free(tables);
+        return false;
+    }
+
+    for (int square = 1; square < board->size; square++) {
+        size_t base = (size_t)square * die_faces;
+        double q[MAX_DIE_FACES];
+        double q_total = 0.0;
+
+        for (int r = 0; r < die_faces; r++) {
+            int next = rules_target(board->rules, board->size, square, r + 1);
+            double tilt = 1.0;
+
+            if (square + r + 1 > board->size && next != board->size) {
+                tilt = bias;           // Overshoot without finishing (delays the game)
+                next = (next == square) ? square : board_apply_jump(board, next);
+            } else {
+                int jumped = board_apply_jump(board, next);
+                if (jumped == board->size || jumped > next) {
+                    tilt = 1.0 / bias; // Winning roll or ladder (advances the game)
+                } else if (jumped < next) {
+                    tilt = bias;       // Snake (delays the game)
+                }
+                next = jumped;
+            }
+
+            tables->dest[base + r] = next;
+            q[r] = p[r] * tilt;
+            q_total += q[r];
+        }
+
+        double running = 0.0;
+        for (int r = 0; r < die_faces; r++) {
+            q[r] /= q_total;
+            running += q[r];
+            tables->cumulative[base + r] = running;
+            tables->log_ratio[base + r] = log(p[r] / q[r]);
+        }
+        tables->cumulative[base + die_faces - 1] = 1.0; // Guard against rounding
+    }
+
+    return true;
+}
+
+/**
+ * Runs `num_games` tilted games for at most `threshold` rolls each and
+ * accumulates the likelihood ratios of the games that were not won.
+ */
+static TailSums run_tilted_games(const TiltTables* tables, const Board* board,
+                                 int threshold, uint64_t num_games) {
+    DiceRng* rng = dice_default_rng();
+    TailSums sums = {0.0, 0.0, 0};
+
+    for (uint64_t g = 0; g < num_games; g++) {
+        int position = 1;
+        double log_w = 0.0;
+        int moves = 0;
+
+        while (moves < threshold && position != board->size) {
+            size_t base = (size_t)position * tables->die_faces;
+            double u = dice_rng_unit(rng);
+            int r = 0;
+            while (u > tables->cumulative[base + r]) r++;
+
+            log_w += tables->log_ratio[base + r];
+            position = tables->dest[base + r];
+            moves++;
+        }
+
+        // Event: not won after `threshold` rolls
+        if (position != board->size) {
+            double w = exp(log_w);
+            sums.sum_w += w;
+            sums.sum_w2 += w * w;
+            sums.hits++;
+        }
+    }
+
+    return sums;
+}
+
+static double effective_samples(const TailSums* sums) {
+    return (sums->sum_w2 > 0.0) ? (sums->sum_w * sums->sum_w) / sums->sum_w2 : 0.0;
+}
+
+/**
+ * Outcome of one splitting run.
+ */
+typedef struct {
+    double log_estimate;       // log of the estimate, -INFINITY if every game was won
+    double relative_variance;  // Estimated variance of the estimate divided by its square
+    double lineages;           // Effective number of starting games the survivors descend from
+    uint64_t survivors;        // Games still running after the last roll
+} SplitRun;
+
+/**
+ * Per-game state of a splitting run, double buffered for resampling.
+ */
+typedef struct {
+    int* positions;
+    int* spare_positions;
+    uint32_t* origins;        // Starting game each game descends from
+    uint32_t* spare_origins;
+    uint32_t* counts;         // Games per starting game
+} SplitBuffers;
+
+static void split_buffers_free(SplitBuffers* buffers) {
+    free(buffers->positions);
+    free(buffers->spare_positions);
+    free(buffers->origins);
+    free(buffers->spare_origins);
+    free(buffers->counts);
+}
+
+static bool split_buffers_init(SplitBuffers* buffers, uint32_t particles) {
+    buffers->positions = malloc((size_t)particles * sizeof(int));
+    buffers->spare_positions = malloc((size_t)particles * sizeof(int));
+    buffers->origins = malloc((size_t)particles * sizeof(uint32_t));
+    buffers->spare_origins = malloc((size_t)particles * sizeof(uint32_t));
+    buffers->counts = malloc((size_t)particles * sizeof(uint32_t));
+    if (!buffers->positions || !buffers->spare_positions || !buffers->origins ||
+        !buffers->spare_origins || !buffers->counts) {
+        split_buffers_free(buffers);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * One fixed-effort splitting run: `particles` games advance together one roll
+ * at a time and games that are won drop out. Whenever fewer than
+ * TAIL_SPLIT_RESAMPLE_FRACTION of the games are still running, all
+ * `particles` slots are refilled with copies of randomly chosen running games
+ * (multinomial resampling). The product of the fractions still running at
+ * each refill and at the end is an unbiased estimate of P(moves > threshold).
+ *
+ * Each game remembers which starting game it descends from. The variance is
+ * estimated from how the survivors' ancestries spread (Lee & Whiteley,
+ * "Variance estimation in the particle filter", 2018, with Du & Guyader's
+ * extension to adaptive resampling): with c_e of the A survivors descending
+ * from start e after R refills,
+ * Var / estimate^2 = 1 - (N / (N - 1))^(R + 1) * (1 - sum c_e^2 / A^2).
+ */
+static SplitRun run_split_games(const TiltTables* tables, const Board* board, int threshold,
+                                SplitBuffers* buffers, uint32_t particles) {
+    int* positions = buffers->positions;
+    uint32_t* origins = buffers->origins;
+    DiceRng* rng = dice_default_rng();
+    SplitRun run = {0.0, 0.0, 0.0, 0};
+    uint32_t alive = particles;
+    int refills = 0;
+
+    for (uint32_t i = 0; i < particles; i++) {
+        positions[i] = 1;
+        origins[i] = i;
+    }
+
+    for (int moves = 0; moves < threshold; moves++) {
+        uint32_t running = 0;
+        for (uint32_t i = 0; i < alive; i++) {
+            size_t base = (size_t)positions[i] * tables->die_faces;
+            double u = dice_rng_unit(rng);
+            int r = 0;
+            while (u > tables->cumulative[base + r]) r++;
+
+            int position = tables->dest[base + r];
+            if (position != board->size) {
+                positions[running] = position;
+                origins[running++] = origins[i];
+            }
+        }
+        alive = running;
+        if (alive == 0) {
+            run.log_estimate = -INFINITY;
+            return run;
+        }
+        if (alive >= particles * TAIL_SPLIT_RESAMPLE_FRACTION || moves + 1 == threshold) continue;
+
+        // The variance estimate below holds for multinomial resampling only
+        run.log_estimate += log((double)alive / (double)particles);
+        int* next_positions = (positions == buffers->positions) ? buffers->spare_positions : buffers->positions;
+        uint32_t* next_origins = (origins == buffers->origins) ? buffers->spare_origins : buffers->origins;
+        for (uint32_t i = 0; i < particles; i++) {
+            uint32_t pick = (uint32_t)(dice_rng_unit(rng) * alive);
+            if (pick >= alive) pick = alive - 1;
+            next_positions[i] = positions[pick];
+            next_origins[i] = origins[pick];
+        }
+        positions = next_positions;
+        origins = next_origins;
+        alive = particles;
+        refills++;
+    }
+    run.log_estimate += log((double)alive / (double)particles);
+
+    uint32_t* counts = buffers->counts;
+    memset(counts, 0, particles * sizeof(uint32_t));
+    for (uint32_t i = 0; i < alive; i++) counts[origins[i]]++;
+    double share = 0.0;  // Probability that two survivors share a starting game
+    for (uint32_t i = 0; i < particles; i++) share += (double)counts[i] * counts[i];
+    share /= (double)alive * alive;
+
+    run.lineages = 1.0 / share;
+    run.survivors = alive;
+    if (particles > 1) {
+        double n = (double)particles;
+        double variance = 1.0 - pow(n / (n - 1.0), refills + 1.0) * (1.0 - share);
+        run.relative_variance = variance > 0.0 ? variance : 0.0;
+    }
+    return run;
+}
+
+/**
+ * Estimates P(moves > threshold) with splitting. Games beyond
+ * TAIL_SPLIT_MAX_PARTICLES are spread over independent runs whose estimates
+ * are averaged. Runs are combined relative to the largest estimate, so tails
+ * far below the smallest double squared keep a standard error.
+ */
+static bool estimate_by_splitting(const TiltTables* tables, const Board* board, int threshold,
+                                  uint64_t num_games, TailEstimate* out) {
+    uint64_t runs = (num_games + TAIL_SPLIT_MAX_PARTICLES - 1) / TAIL_SPLIT_MAX_PARTICLES;
+    uint32_t particles = (uint32_t)(num_games / runs);
+
+    SplitBuffers buffers;
+    SplitRun* results = malloc(runs * sizeof(SplitRun));
+    if (!results || !split_buffers_init(&buffers, particles)) {
+        free(results);
+        return false;
+    }
+
+    double largest = -INFINITY;
+    bool died_out = false;
+    for (uint64_t k = 0; k < runs; k++) {
+        results[k] = run_split_games(tables, board, threshold, &buffers, particles);
+        if (results[k].survivors == 0) died_out = true;
+        if (results[k].log_estimate > largest) largest = results[k].log_estimate;
+    }
+
+    double sum = 0.0, variance = 0.0, lineages = 0.0;
+    uint64_t survivors = 0;
+    for (uint64_t k = 0; k < runs; k++) {
+        double scaled = (largest > -INFINITY) ? exp(results[k].log_estimate - largest) : 0.0;
+        sum += scaled;
+        variance += scaled * scaled * results[k].relative_variance;
+        lineages += results[k].lineages;
+        survivors += results[k].survivors;
+    }
+    double scale = (largest > -INFINITY) ? exp(largest) : 0.0;
+
+    out->probability = sum / runs * scale;
+    out->std_error = sqrt(variance) / runs * scale;
+    out->effective_samples = lineages;
+    out->hits = survivors;
+    out->num_games = (uint64_t)particles * runs;
+    // Few surviving lineages leave the variance estimate itself unreliable
+    out->reliable = !died_out && lineages >= TAIL_MIN_ESS;
+
+    split_buffers_free(&buffers);
+    free(results);
+    return true;
+}
+
+/**
+ * Estimates P(moves > threshold), see rare.h.
+ *
+ * The tables make the per-roll work one table walk and one addition.
+ * A fixed tilt suits only a narrow range of thresholds: too strong a tilt
+ * makes the weights degenerate, too weak a tilt never reaches the tail.
+ * The automatic mode therefore does not tilt at all and splits instead,
+ * which needs no tuning for any threshold.
+ */
+bool simulate_tail_probability(
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    int threshold,
+    uint64_t num_games,
+    double bias,
+    TailEstimate* out,
+    const char** reason
+) {
+    const char* unused;
+    if (!reason) reason = &unused;
+    *reason = NULL;
+
+    if (!board || !out || threshold < 0 || num_games == 0 || (bias > 0.0 && bias < 1.0)) {
+        *reason = "invalid parameters";
+        return false;
+    }
+    if (board->rules & RULE_THREE_MAX_HOME) {
+        *reason = "THREE_MAX_HOME is not supported"; // Not a Markov chain on squares
+        return false;
+    }
+    if (die_faces <= 0 || die_faces > MAX_DIE_FACES ||
+        (use_non_uniform && !dice_validate_probabilities(probabilities, die_faces))) {
+        *reason = "invalid die";
+        return false;
+    }
+
+    // Nominal roll probabilities p(r)
+    double p[MAX_DIE_FACES];
+    double total_weight = 0.0;
+    for (int r = 0; r < die_faces; r++) {
+        p[r] = use_non_uniform ? probabilities[r] : 1.0;
+        total_weight += p[r];
+    }
+    for (int r = 0; r < die_faces; r++) {
+        p[r] /= total_weight;
+    }
+
+    // Splitting rolls the nominal die, a bias of 1.0 leaves it untilted
+    TiltTables tables;
+    if (!tilt_tables_build(&tables, board, die_faces, p, (bias <= 0.0) ? 1.0 : bias)) {
+        *reason = "out of memory";
+        return false;
+    }
+
+    if (bias <= 0.0) {
+        bool ok = estimate_by_splitting(&tables, board, threshold, num_games, out);
+        tilt_tables_free(&tables);
+        if (!ok) {
+            *reason = "out of memory";
+            return false;
+        }
+        out->bias = TAIL_BIAS_AUTO;
+        return true;
+    }
+
+    TailSums sums = run_tilted_games(&tables, board, threshold, num_games);
+    tilt_tables_free(&tables);
+
+    double n = (double)num_games;
+    double mean = sums.sum_w / n;
+    double variance = (num_games > 1)
+                    ? (sums.sum_w2 / n - mean * mean) * n / (n - 1.0)
+                    : 0.0;
+
+    out->probability = mean;
+    out->std_error = (variance > 0.0) ? sqrt(variance / n) : 0.0;
+    out->effective_samples = effective_samples(&sums);
+    out->bias = bias;
+    out->hits = sums.hits;
+    out->num_games = num_games;
+    out->reliable = out->effective_samples >= TAIL_MIN_ESS;
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "board.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TAIL_BIAS_AUTO 0.0  // Pass as `bias` to estimate by splitting instead of tilting
+#define TAIL_MIN_ESS   100  // Estimates below this effective sample size are unreliable
+
+/**
+ * Result of a rare-event estimation of P(moves > threshold).
+ */
+typedef struct {
+    double probability;        // Estimate of P(moves > threshold)
+    double std_error;          // Standard error of the estimate
+    double effective_samples;  // Tilted: (sum w)^2 / sum w^2 over hits; split: starting games the survivors descend from
+    double bias;               // Tilt factor that was used, TAIL_BIAS_AUTO when split
+    bool reliable;             // false below TAIL_MIN_ESS: a few samples dominate and std_error cannot be trusted
+    uint64_t hits;             // Number of sampled games that were still running after threshold rolls
+    uint64_t num_games;        // Number of sampled games
+} TailEstimate;
+
+/**
+ * Estimates the tail probability P(moves > threshold), i.e. the probability
+ * that a game has not been won after `threshold` rolls.
+ *
+ * Plain Monte Carlo almost never samples very long games. Two remedies are
+ * offered:
+ *
+ * - With a fixed `bias`, die rolls are drawn from a tilted distribution:
+ *   rolls that delay the player (landing on a snake head or overshooting the
+ *   final square) are made `bias` times more likely, rolls that advance the
+ *   player (ladders or the winning roll) are made `bias` times less likely.
+ *   Each sampled game is weighted by its likelihood ratio, so the estimate
+ *   stays unbiased, but a factor only suits a narrow range of thresholds and
+ *   the weights degenerate when it is off (see TAIL_MIN_ESS).
+ *
+ * - With TAIL_BIAS_AUTO the games are split instead: all games advance one
+ *   roll at a time, and whenever half of them have been won they are
+ *   replaced by copies of games still running. P(moves > threshold) is the
+ *   product of the fractions still running at each refill and at the end. This is unbiased, needs no tuning and reaches
+ *   any depth: the error depends on the threshold and on how the board
+ *   mixes, not on the depth of the tail. The standard error is estimated
+ *   from how many starting games the surviving games descend from, which
+ *   also gives the effective sample size.
+ *
+ * Games are only simulated up to `threshold` rolls, so the cost per sample is
+ * bounded and thresholds beyond the move cap (simulate_move_cap()) are supported.
+ *
+ * @param board Pointer to the game board.
+ * @param die_faces Number of die faces.
+ * @param use_non_uniform Use weighted die if true.
+ * @param probabilities Weights for non-uniform die (if enabled).
+ * @param threshold Number of rolls n in P(moves > n).
+ * @param num_games Number of games to sample.
+ * @param bias Tilt factor (>= 1.0, 1.0 gives plain Monte Carlo),
+ *             or TAIL_BIAS_AUTO to split games instead.
+ * @param out Output structure for the estimate. Check `reliable` before
+ *            reporting std_error as a confidence interval.
+ * @param reason Optional output: why it failed (may be NULL).
+ * @return true on success, false on invalid parameters or allocation failure.
+ *         Boards using RULE_THREE_MAX_HOME are not supported.
+ */
+bool simulate_tail_probability(
+    const Board* board,
+    int die_faces,
+    bool use_non_uniform,
+    const int* probabilities,
+    int threshold,
+    uint64_t num_games,
+    double bias,
+    TailEstimate* out,
+    const char** reason
+);
@@ -0,0 +1,278 @@
+#define _POSIX_C_SOURCE 200809L  // for getpid(), fseeko() and ftello()
+
+#include "resultcache.h"
+#include "fnv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC       0x534C5243U  // "SLRC"
+#define CACHE_PATH_LIMIT  4096
+#define CACHE_COPY_BUFFER (64 * 1024)   // Chunk size when carrying checkpoints over to a new file
+
+/**
+ * Fixed-size header of one checkpoint in a cache file. Every field is 64
+ * bits wide so the layout has no padding. Files use the host byte order;
+ * the cache is local.
+ */
+typedef struct {
+    uint64_t magic;
+    uint64_t version;
+    uint64_t key;
+    uint64_t die_faces;
+    uint64_t games;
+    uint64_t wins;
+    uint64_t total_moves;
+    uint64_t total_turns;
+    uint64_t rng_state;
+    uint64_t found_win;
+    uint64_t shortest_moves;
+    uint64_t shortest_turns;
+    uint64_t stats_games;
+    uint64_t num_jumps;      // (square, hits) pairs that follow the shortest game's rolls
+} CacheHeader;
+
+/**
+ * Position of one checkpoint (header and body) in a cache file.
+ */
+typedef struct {
+    uint64_t games;
+    off_t offset;
+    off_t size;
+} Checkpoint;
+
+/**
+ * Hashes the normalised run parameters; see resultcache.h.
+ */
+uint64_t result_cache_key(const Board* board, int die_faces, bool use_non_uniform,
+                          const int* probabilities, uint64_t seed) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    if (!board) return hash;
+
+    hash = fnv_hash_u64(hash, RESULT_CACHE_VERSION);
+    hash = fnv_hash_u64(hash, (uint64_t)simulate_move_cap(board));
+    hash = fnv_hash_u64(hash, (uint64_t)board->width);
+    hash = fnv_hash_u64(hash, (uint64_t)board->height);
+    hash = fnv_hash_u64(hash, board->rules);
+
+    // Jumps in square order: independent of the order of the config lines
+    for (int s = 1; s <= board->size; s++) {
+        if (board->jump_dest[s] > 0) {
+            hash = fnv_hash_u64(hash, (uint64_t)s);
+            hash = fnv_hash_u64(hash, (uint64_t)board->jump_dest[s]);
+        }
+    }
+
+    hash = fnv_hash_u64(hash, (uint64_t)die_faces);
+    hash = fnv_hash_u64(hash, use_non_uniform);
+    for (int r = 0; use_non_uniform && probabilities && r < die_faces; r++) {
+        hash = fnv_hash_u64(hash, (uint64_t)probabilities[r]);
+    }
+    return fnv_hash_u64(hash, seed);
+}
+
+/**
+ * Builds the file name of a key. Returns false if it does not fit.
+ */
+static bool cache_path(char* path, size_t size, const char* directory, uint64_t key) {
+    int length = snprintf(path, size, "%s/%016llx.res", directory, (unsigned long long)key);
+    return length > 0 && (size_t)length < size;
+}
+
+/**
+ * Reads the header at the current position and checks that it belongs to
+ * `key` and fits the board.
+ */
+static bool read_header(FILE* file, uint64_t key, const Board* board, int die_faces, CacheHeader* header) {
+    return fread(header, sizeof(*header), 1, file) == 1 &&
+           header->magic == CACHE_MAGIC && header->version == RESULT_CACHE_VERSION &&
+           header->key == key && header->die_faces == (uint64_t)die_faces &&
+           header->shortest_moves <= (uint64_t)simulate_move_cap(board) &&
+           header->num_jumps == (uint64_t)(board->num_snakes + board->num_ladders);
+}
+
+/**
+ * Lists the checkpoints of a cache file in file order, which is ascending
+ * game count. Stops at the first entry that is invalid or truncated.
+ * Returns the number of checkpoints found.
+ */
+static int scan_checkpoints(FILE* file, uint64_t key, const Board* board, int die_faces,
+                            Checkpoint* checkpoints) {
+    if (fseeko(file, 0, SEEK_END) != 0) return 0;
+    off_t file_size = ftello(file);
+
+    int count = 0;
+    off_t offset = 0;
+    CacheHeader header;
+    while (count < RESULT_CACHE_MAX_CHECKPOINTS && offset < file_size &&
+           fseeko(file, offset, SEEK_SET) == 0 && read_header(file, key, board, die_faces, &header)) {
+        off_t size = (off_t)sizeof(header) + (off_t)header.shortest_moves +
+                     (off_t)header.num_jumps * (off_t)(2 * sizeof(uint64_t));
+        if (offset + size > file_size) break;
+
+        checkpoints[count].games = header.games;
+        checkpoints[count].offset = offset;
+        checkpoints[count].size = size;
+        offset += size;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Finds the checkpoint with the most games not exceeding `max_games`,
+ * reads it into a scratch run and only copies it over `run` once
+ * everything has been validated.
+ */
+bool result_cache_load(const char* directory, uint64_t key, const Board* board, int die_faces,
+                       uint64_t max_games, RunResult* run) {
+    if (!directory || !board || !run || !run->shortest.moves) return false;
+
+    char path[CACHE_PATH_LIMIT];
+    if (!cache_path(path, sizeof(path), directory, key)) return false;
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    Checkpoint checkpoints[RESULT_CACHE_MAX_CHECKPOINTS];
+    int count = scan_checkpoints(file, key, board, die_faces, checkpoints);
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (checkpoints[i].games <= max_games && (best < 0 || checkpoints[i].games > checkpoints[best].games)) {
+            best = i;
+        }
+    }
+
+    CacheHeader header;
+    bool ok = best >= 0 && fseeko(file, checkpoints[best].offset, SEEK_SET) == 0 &&
+              read_header(file, key, board, die_faces, &header);
+
+    RunResult loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    ok = ok && stats_init(&loaded.stats, board) && game_result_init(&loaded.shortest, board);
+
+    if (ok) {
+        loaded.games = header.games;
+        loaded.wins = header.wins;
+        loaded.total_moves = header.total_moves;
+        loaded.total_turns = header.total_turns;
+        loaded.rng.state = header.rng_state;
+        loaded.found_win = header.found_win != 0;
+        loaded.shortest.move_count = (int)header.shortest_moves;
+        loaded.shortest.turn_count = (int)header.shortest_turns;
+        loaded.shortest.die_faces = die_faces;
+        loaded.shortest.won = loaded.found_win;
+        loaded.stats.total_games = header.stats_games;
+        ok = fread(loaded.shortest.moves, 1, header.shortest_moves, file) == header.shortest_moves;
+    }
+
+    // Usage counts are stored per jump start square, mapped back to this board's slots
+    for (uint64_t i = 0; ok && i < header.num_jumps; i++) {
+        uint64_t pair[2];
+        ok = fread(pair, sizeof(pair), 1, file) == 1 &&
+             pair[0] >= 1 && pair[0] <= (uint64_t)board->size;
+        if (!ok) break;
+
+        int square = (int)pair[0];
+        int dest = board->jump_dest[square];
+        int slot = board->jump_slot[square];
+        if (dest > square) loaded.stats.ladder_hits[slot] = pair[1];
+        else if (dest > 0) loaded.stats.snake_hits[slot] = pair[1];
+        else ok = false; // No jump starts there on this board
+    }
+    fclose(file);
+
+    if (!ok) {
+        run_result_free(&loaded);
+        return false;
+    }
+    run_result_free(run);
+    *run = loaded;
+    return true;
+}
+
+/**
+ * Writes one checkpoint: header, shortest game and usage counts.
+ */
+static bool write_checkpoint(FILE* file, uint64_t key, const Board* board, int die_faces, const RunResult* run) {
+    int shortest_moves = run->found_win ? run->shortest.move_count : 0;
+    CacheHeader header = {
+        CACHE_MAGIC, RESULT_CACHE_VERSION, key, (uint64_t)die_faces,
+        run->games, run->wins, run->total_moves, run->total_turns, run->rng.state,
+        run->found_win, (uint64_t)shortest_moves, (uint64_t)run->shortest.turn_count,
+        run->stats.total_games, (uint64_t)(board->num_snakes + board->num_ladders),
+    };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    ok = ok && fwrite(run->shortest.moves, 1, shortest_moves, file) == (size_t)shortest_moves;
+
+    for (int i = 0; ok && i < board->num_ladders; i++) {
+        uint64_t pair[2] = { (uint64_t)board->ladders[i].start, run->stats.ladder_hits[i] };
+        ok = fwrite(pair, sizeof(pair), 1, file) == 1;
+    }
+    for (int i = 0; ok && i < board->num_snakes; i++) {
+        uint64_t pair[2] = { (uint64_t)board->snakes[i].start, run->stats.snake_hits[i] };
+        ok = fwrite(pair, sizeof(pair), 1, file) == 1;
+    }
+    return ok;
+}
+
+/**
+ * Copies one checkpoint of the previous file unchanged.
+ */
+static bool copy_checkpoint(FILE* from, FILE* to, const Checkpoint* checkpoint) {
+    char buffer[CACHE_COPY_BUFFER];
+    if (fseeko(from, checkpoint->offset, SEEK_SET) != 0) return false;
+
+    for (off_t left = checkpoint->size; left > 0; ) {
+        size_t chunk = left < (off_t)sizeof(buffer) ? (size_t)left : sizeof(buffer);
+        if (fread(buffer, 1, chunk, from) != chunk || fwrite(buffer, 1, chunk, to) != chunk) return false;
+        left -= (off_t)chunk;
+    }
+    return true;
+}
+
+/**
+ * Merges the run into the existing checkpoints (replacing one with the same
+ * game count), writes them to a temporary file and renames it into place.
+ */
+bool result_cache_store(const char* directory, uint64_t key, const Board* board, int die_faces,
+                        const RunResult* run) {
+    if (!directory || !board || !run) return false;
+
+    char path[CACHE_PATH_LIMIT], temp_path[CACHE_PATH_LIMIT + 32];
+    if (!cache_path(path, sizeof(path), directory, key)) return false;
+    snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", path, (long)getpid());
+
+    // Existing checkpoints plus the new one (offset -1), in ascending game count
+    Checkpoint merged[RESULT_CACHE_MAX_CHECKPOINTS + 1];
+    Checkpoint existing[RESULT_CACHE_MAX_CHECKPOINTS];
+    FILE* previous = fopen(path, "rb");
+    int count = previous ? scan_checkpoints(previous, key, board, die_faces, existing) : 0;
+    int merged_count = 0;
+    bool inserted = false;
+    for (int i = 0; i <= count; i++) {
+        if (!inserted && (i == count || existing[i].games >= run->games)) {
+            merged[merged_count++] = (Checkpoint){ run->games, -1, 0 };
+            inserted = true;
+        }
+        if (i < count && existing[i].games != run->games) merged[merged_count++] = existing[i];
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    bool ok = file != NULL;
+
+    // Beyond the limit the checkpoints with the fewest games are dropped
+    int first = merged_count > RESULT_CACHE_MAX_CHECKPOINTS ? merged_count - RESULT_CACHE_MAX_CHECKPOINTS : 0;
+    for (int i = first; ok && i < merged_count; i++) {
+        ok = merged[i].offset < 0 ? write_checkpoint(file, key, board, die_faces, run)
+                                  : copy_checkpoint(previous, file, &merged[i]);
+    }
+
+    if (previous) fclose(previous);
+    if (file) ok = (fclose(file) == 0) && ok;
+    if (ok) ok = rename(temp_path, path) == 0;
+    if (!ok && file) remove(temp_path);
+    return ok;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "board.h"
+#include "runresult.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESULT_CACHE_VERSION        3   // Bump when the file layout or the simulation changes
+#define RESULT_CACHE_MAX_CHECKPOINTS 16  // Game counts kept per key
+
+/**
+ * Computes the cache key of a run: a 64-bit FNV-1a hash of the normalised
+ * board (dimensions, rules and every jump in square order, so the order of
+ * lines in the config does not matter), the die faces and weights, the seed
+ * and the simulation format. The game count is not part of the key: the
+ * file of a key holds checkpoints of the same random stream after different
+ * numbers of games, so any shorter or longer request can start from one.
+ *
+ * @param board Pointer to the board.
+ * @param die_faces Number of die faces.
+ * @param use_non_uniform Use weighted die if true.
+ * @param probabilities Weights for non-uniform die (if enabled).
+ * @param seed Seed of the run.
+ * @return The key.
+ */
+uint64_t result_cache_key(const Board* board, int die_faces, bool use_non_uniform,
+                          const int* probabilities, uint64_t seed);
+
+/**
+ * Loads the cached checkpoint for `key` with the most games not exceeding
+ * `max_games` from `directory`, replacing the contents of `run` (initialized
+ * with run_result_init() for the same board). The loaded run is exactly the
+ * first run->games games of the seeded stream; extend it with
+ * run_result_extend() to reach `max_games`.
+ * A missing, truncated or mismatching file counts as a miss.
+ *
+ * @param directory Cache directory.
+ * @param key Key from result_cache_key().
+ * @param board Pointer to the board of the run.
+ * @param die_faces Number of die faces.
+ * @param max_games Largest game count wanted.
+ * @param run Run to fill.
+ * @return true on a hit, false on a miss (run is left unchanged).
+ */
+bool result_cache_load(const char* directory, uint64_t key, const Board* board, int die_faces,
+                       uint64_t max_games, RunResult* run);
+
+/**
+ * Stores a run under `key` in `directory` as a checkpoint for its game count,
+ * next to the checkpoints already there (one file per key). Once a file holds
+ * RESULT_CACHE_MAX_CHECKPOINTS checkpoints, those with the fewest games are
+ * dropped. The file is written under a temporary name and renamed, so
+ * concurrent readers never see a partial entry.
+ *
+ * @param directory Cache directory (must exist).
+ * @param key Key from result_cache_key().
+ * @param board Pointer to the board of the run.
+ * @param die_faces Number of die faces.
+ * @param run Run to store.
+ * @return true on success, false on a write error.
+ */
+bool result_cache_store(const char* directory, uint64_t key, const Board* board, int die_faces,
+                        const RunResult* run);
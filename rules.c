@@ -0,0 +1,58 @@
+#include "rules.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Config names of the individual rule flags, in bit order.
+ */
+static const char* const RULE_NAMES[RULE_COUNT] = {
+    "BOUNCE_BACK",
+    "OVERSHOOT_WINS",
+    "REROLL_ON_MAX",
+    "THREE_MAX_HOME",
+};
+
+/**
+ * Adds a named rule to the set.
+ * The overshoot rules (EXACT_FINISH, BOUNCE_BACK, OVERSHOOT_WINS) are
+ * mutually exclusive, so combining two of them is rejected.
+ */
+bool rules_add(RuleSet* rules, const char* name) {
+    if (!rules || !name) return false;
+
+    const RuleSet overshoot = RULE_BOUNCE_BACK | RULE_OVERSHOOT_WINS;
+
+    if (strcmp(name, "EXACT_FINISH") == 0) {
+        if (*rules & overshoot) return false;
+        return true;
+    }
+
+    for (int i = 0; i < RULE_COUNT; i++) {
+        if (strcmp(name, RULE_NAMES[i]) == 0) {
+            RuleSet flag = 1u << i;
+            if ((flag & overshoot) && (*rules & overshoot & ~flag)) return false;
+            *rules |= flag;
+            return true;
+        }
+    }
+
+    return false; // Unknown rule name
+}
+
+/**
+ * Prints the active rule names. EXACT_FINISH is listed when no other
+ * overshoot rule is active, so the line is never empty.
+ */
+void rules_print(RuleSet rules) {
+    printf("Rules:");
+    if (!(rules & (RULE_BOUNCE_BACK | RULE_OVERSHOOT_WINS))) {
+        printf(" EXACT_FINISH");
+    }
+
+    for (int i = 0; i < RULE_COUNT; i++) {
+        if (rules & (1u << i)) {
+            printf(" %s", RULE_NAMES[i]);
+        }
+    }
+    printf("\n");
+}
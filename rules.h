@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+
+/// Bit flags selecting a rule variant. 0 is the classic rule set:
+/// start on square 1, exact roll needed to finish (overshoot stays in place),
+/// single player, no extra turns.
+typedef unsigned int RuleSet;
+
+#define RULE_BOUNCE_BACK    (1u << 0)  // Overshoot bounces back from the final square
+#define RULE_OVERSHOOT_WINS (1u << 1)  // Reaching or passing the final square wins
+#define RULE_REROLL_ON_MAX  (1u << 2)  // Rolling the highest face grants another roll this turn
+#define RULE_THREE_MAX_HOME (1u << 3)  // Three highest-face rolls in a row send the player to square 1
+
+#define RULE_COUNT        4
+#define RULE_COMBINATIONS (1u << RULE_COUNT)  // Number of distinct rule sets
+#define RULE_MAX_STREAK   3                   // Highest-face rolls in a row that send a player home
+
+// RULE_THREE_MAX_HOME counts consecutive highest-face rolls, not rolls within
+// one turn: any other roll resets the streak, a turn boundary does not.
+// Without RULE_REROLL_ON_MAX every roll is a turn, so the highest face on
+// three turns in a row sends the player home. With it a highest-face roll
+// always continues the turn, so the streak never spans two turns.
+// The game kernel (simulator.c) and stats_update() both follow this.
+
+/**
+ * Adds the rule with the given config name to a rule set.
+ * Accepted names: EXACT_FINISH (the default, clears the overshoot rules),
+ * BOUNCE_BACK, OVERSHOOT_WINS, REROLL_ON_MAX, THREE_MAX_HOME.
+ *
+ * @param rules Rule set to update.
+ * @param name Rule name as written in the config file.
+ * @return true if the name is known and compatible with the current rules.
+ */
+bool rules_add(RuleSet* rules, const char* name);
+
+/**
+ * Prints the active rules on one line (for board_print()).
+ * @param rules Rule set to print.
+ */
+void rules_print(RuleSet rules);
+
+/**
+ * Square a player moves to (before snakes and ladders) when rolling `roll`
+ * on `position`, according to the overshoot rules.
+ *
+ * @param rules Active rule set.
+ * @param size Number of squares on the board (final square).
+ * @param position Current square.
+ * @param roll Die roll.
+ * @return Target square in [1, size].
+ */
+static inline int rules_target(RuleSet rules, int size, int position, int roll) {
+    int target = position + roll;
+    if (target <= size) return target;
+
+    if (rules & RULE_OVERSHOOT_WINS) return size;
+    if (rules & RULE_BOUNCE_BACK) {
+        target = 2 * size - target;
+        return (target < 1) ? 1 : target;
+    }
+    return position; // Exact finish: stay in place
+}
@@ -0,0 +1,67 @@
+#include "runresult.h"
+#include <string.h>
+
+/**
+ * Creates an empty run with a freshly seeded generator.
+ */
+bool run_result_init(RunResult* run, const Board* board, uint64_t seed) {
+    if (!run) return false;
+
+    memset(run, 0, sizeof(*run));
+    dice_rng_seed(&run->rng, seed);
+    if (!stats_init(&run->stats, board) || !game_result_init(&run->shortest, board)) {
+        run_result_free(run);
+        return false;
+    }
+    return true;
+}
+
+void run_result_free(RunResult* run) {
+    if (!run) return;
+
+    stats_free(&run->stats);
+    game_result_free(&run->shortest);
+    memset(run, 0, sizeof(*run));
+}
+
+/**
+ * Continues the run's single random stream for `games` more games.
+ */
+bool run_result_extend(RunResult* run, const Board* board, int die_faces, bool use_non_uniform,
+                       const int* probabilities, uint64_t games, uint64_t* occupancy,
+                       Progress* progress) {
+    if (!run || !board) return false;
+
+    GameResult result;
+    if (!game_result_init(&result, board)) return false;
+
+    // Run in chunks so the progress counters are touched once per chunk, not per game
+    for (uint64_t done = 0; done < games; ) {
+        uint64_t chunk = games - done < PROGRESS_CHUNK_GAMES ? games - done : PROGRESS_CHUNK_GAMES;
+        uint64_t chunk_wins = 0, chunk_moves = 0;
+
+        for (uint64_t g = 0; g < chunk; g++) {
+            simulate_game_counted(board, die_faces, &result, use_non_uniform, probabilities,
+                                  &run->rng, occupancy);
+            if (!result.won) continue;
+
+            chunk_wins++;
+            chunk_moves += result.move_count;
+            run->total_turns += result.turn_count;
+            if (!run->found_win || result.move_count < run->shortest.move_count) {
+                game_result_copy(&run->shortest, &result);
+                run->found_win = true;
+            }
+            stats_update(board, &result, &run->stats);
+        }
+
+        run->games += chunk;
+        run->wins += chunk_wins;
+        run->total_moves += chunk_moves;
+        done += chunk;
+        progress_add(progress, chunk, chunk_wins, chunk_moves);
+    }
+
+    game_result_free(&result);
+    return true;
+}
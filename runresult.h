@@ -0,0 +1,63 @@
+#pragma once
+
+#include "board.h"
+#include "dice.h"
+#include "progress.h"
+#include "simulator.h"
+#include "stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Aggregate results of a seeded, single-stream simulation run, together with
+ * the generator state after its last game so the run can be extended later
+ * exactly as if it had been longer from the start.
+ */
+typedef struct {
+    uint64_t games;         // Games simulated
+    uint64_t wins;          // Games that reached the final square
+    uint64_t total_moves;   // Sum of moves over won games
+    uint64_t total_turns;   // Sum of turns over won games (differs under RULE_REROLL_ON_MAX)
+    GameResult shortest;    // Shortest winning game
+    bool found_win;         // true if `shortest` holds a game
+    Stats stats;            // Snake and ladder usage (won games)
+    DiceRng rng;            // Generator state after the last game
+} RunResult;
+
+/**
+ * Initializes an empty run whose generator is seeded with `seed`.
+ * Release it with run_result_free().
+ *
+ * @param run Pointer to the run.
+ * @param board Pointer to the board (sizes the Stats and the shortest game).
+ * @param seed Seed of the run.
+ * @return true on success, false on invalid parameters or allocation failure.
+ */
+bool run_result_init(RunResult* run, const Board* board, uint64_t seed);
+
+/**
+ * Releases the memory held by a run.
+ *
+ * @param run Pointer to the run.
+ */
+void run_result_free(RunResult* run);
+
+/**
+ * Simulates `games` more games on the run's generator and adds them to its
+ * totals. A single pass collects the average, the shortest win, the snake
+ * and ladder usage and, optionally, the landings of every game.
+ *
+ * @param run Pointer to the run.
+ * @param board Pointer to the game board.
+ * @param die_faces Number of die faces.
+ * @param use_non_uniform Use weighted die if true.
+ * @param probabilities Weights for non-uniform die (if enabled).
+ * @param games Number of games to add.
+ * @param occupancy Per-square landing counters (see simulate_game_counted()), or NULL.
+ * @param progress Optional progress reporter, updated once every
+ *                 PROGRESS_CHUNK_GAMES games (may be NULL).
+ * @return true on success, false on invalid parameters or allocation failure.
+ */
+bool run_result_extend(RunResult* run, const Board* board, int die_faces, bool use_non_uniform,
+                       const int* probabilities, uint64_t games, uint64_t* occupancy,
+                       Progress* progress);
@@ -0,0 +1,340 @@
+#define _POSIX_C_SOURCE 200809L  // for clock_gettime()
+
+#include "scheduler.h"
+#include "dice.h"
+#include "simulator.h"
+#include "timing.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEQUE_INITIAL_CAPACITY 64
+#define COST_SMOOTHING         0.25  // Weight of the newest measurement in the cost average
+
+/**
+ * A range of games of one job.
+ */
+typedef struct {
+    int job;
+    uint64_t games;
+} Task;
+
+/**
+ * Per-worker double-ended task queue. The owner pushes and pops at the
+ * bottom, thieves take from the top (the oldest, usually largest tasks).
+ * A mutex per deque keeps it simple; it is only contended while stealing.
+ */
+typedef struct {
+    Task* tasks;
+    int capacity;
+    int top;      // Index of the oldest task
+    int count;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+/**
+ * Shared progress of one job, updated once per finished chunk.
+ */
+typedef struct {
+    atomic_uint_least64_t wins;
+    atomic_uint_least64_t total_moves;
+    atomic_int shortest;
+    _Atomic double ns_per_game;  // Smoothed cost estimate, 0 until measured
+} JobState;
+
+typedef struct Scheduler Scheduler;
+
+typedef struct {
+    Scheduler* scheduler;
+    int index;
+    TaskDeque deque;
+    DiceRng rng;
+    GameResult result;    // Roll buffer sized for the largest board among the jobs
+    uint64_t tasks;
+    uint64_t steals;
+    double busy_seconds;
+} SchedWorker;
+
+struct Scheduler {
+    SimJob* jobs;
+    JobState* states;
+    SchedWorker* workers;
+    int num_workers;
+    Progress* progress;
+    atomic_uint_least64_t remaining;  // Games not yet simulated, across all jobs
+};
+
+static bool deque_init(TaskDeque* deque) {
+    deque->tasks = malloc(DEQUE_INITIAL_CAPACITY * sizeof(Task));
+    deque->capacity = DEQUE_INITIAL_CAPACITY;
+    deque->top = 0;
+    deque->count = 0;
+    pthread_mutex_init(&deque->lock, NULL);
+    return deque->tasks != NULL;
+}
+
+static void deque_free(TaskDeque* deque) {
+    free(deque->tasks);
+    pthread_mutex_destroy(&deque->lock);
+}
+
+/**
+ * Pushes a task at the bottom. Returns false if the deque could not grow.
+ */
+static bool deque_push(TaskDeque* deque, Task task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        Task* grown = malloc(2 * deque->capacity * sizeof(Task));
+        if (!grown) {
+            pthread_mutex_unlock(&deque->lock);
+            return false;
+        }
+        for (int i = 0; i < deque->count; i++) {
+            grown[i] = deque->tasks[(deque->top + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = grown;
+        deque->capacity *= 2;
+        deque->top = 0;
+    }
+    deque->tasks[(deque->top + deque->count) % deque->capacity] = task;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+/**
+ * Pops the newest task (owner side).
+ */
+static bool deque_pop_bottom(TaskDeque* deque, Task* task) {
+    pthread_mutex_lock(&deque->lock);
+    bool found = deque->count > 0;
+    if (found) {
+        deque->count--;
+        *task = deque->tasks[(deque->top + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/**
+ * Takes the oldest task (thief side).
+ */
+static bool deque_steal_top(TaskDeque* deque, Task* task) {
+    if (pthread_mutex_trylock(&deque->lock) != 0) return false; // Busy: try another victim
+    bool found = deque->count > 0;
+    if (found) {
+        *task = deque->tasks[deque->top];
+        deque->top = (deque->top + 1) % deque->capacity;
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/**
+ * Number of games to run as one task of the given job, from its measured cost.
+ */
+static uint64_t chunk_size(const JobState* state) {
+    double ns_per_game = atomic_load_explicit(&state->ns_per_game, memory_order_relaxed);
+    if (ns_per_game <= 0.0) return SCHEDULER_PROBE_GAMES;
+
+    double games = (double)SCHEDULER_TARGET_TASK_NS / ns_per_game;
+    return games < 1.0 ? 1 : (uint64_t)games;
+}
+
+/**
+ * Finds a task: own deque first, then the other workers' deques starting
+ * at a random victim.
+ */
+static bool find_task(SchedWorker* self, Task* task) {
+    if (deque_pop_bottom(&self->deque, task)) return true;
+
+    Scheduler* scheduler = self->scheduler;
+    int n = scheduler->num_workers;
+    if (n < 2) return false;
+
+    int start = dice_rng_roll_uniform(&self->rng, n) - 1;
+    for (int k = 0; k < n; k++) {
+        int victim = (start + k) % n;
+        if (victim == self->index) continue;
+        if (deque_steal_top(&scheduler->workers[victim].deque, task)) {
+            self->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Simulates one chunk of a job and publishes its totals and cost.
+ */
+static void run_chunk(SchedWorker* self, int job_index, uint64_t games) {
+    Scheduler* scheduler = self->scheduler;
+    const SimJob* job = &scheduler->jobs[job_index];
+    JobState* state = &scheduler->states[job_index];
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint64_t wins = 0, total_moves = 0;
+    int shortest = 0;
+    GameResult* result = &self->result;
+
+    for (uint64_t g = 0; g < games; g++) {
+        simulate_game_rng(job->board, job->die_faces, result, job->use_non_uniform,
+                          job->probabilities, &self->rng);
+        if (result->won) {
+            wins++;
+            total_moves += result->move_count;
+            if (shortest == 0 || result->move_count < shortest) shortest = result->move_count;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = timing_seconds_between(&start, &end);
+    self->busy_seconds += seconds;
+    self->tasks++;
+
+    atomic_fetch_add_explicit(&state->wins, wins, memory_order_relaxed);
+    atomic_fetch_add_explicit(&state->total_moves, total_moves, memory_order_relaxed);
+    if (shortest > 0) {
+        int current = atomic_load_explicit(&state->shortest, memory_order_relaxed);
+        while ((current == 0 || shortest < current) &&
+               !atomic_compare_exchange_weak(&state->shortest, &current, shortest)) {
+        }
+    }
+
+    // Smoothed cost per game (racy read-modify-write is fine for an estimate)
+    double measured = seconds * 1e9 / games;
+    double previous = atomic_load_explicit(&state->ns_per_game, memory_order_relaxed);
+    double updated = previous <= 0.0 ? measured : previous + COST_SMOOTHING * (measured - previous);
+    atomic_store_explicit(&state->ns_per_game, updated, memory_order_relaxed);
+
+    progress_add(scheduler->progress, games, wins, total_moves);
+    atomic_fetch_sub_explicit(&scheduler->remaining, games, memory_order_release);
+}
+
+static void* sched_worker_main(void* arg) {
+    SchedWorker* self = arg;
+    Scheduler* scheduler = self->scheduler;
+
+    while (atomic_load_explicit(&scheduler->remaining, memory_order_acquire) > 0) {
+        Task task;
+        if (!find_task(self, &task)) {
+            sched_yield(); // Work is still running elsewhere and may be split later
+            continue;
+        }
+
+        // Lazy splitting: run one chunk, give the rest back as two stealable halves
+        uint64_t chunk = chunk_size(&scheduler->states[task.job]);
+        if (task.games > chunk) {
+            uint64_t rest = task.games - chunk;
+            Task first = { task.job, rest / 2 };
+            Task second = { task.job, rest - rest / 2 };
+
+            // If a push fails (out of memory) those games stay with this chunk
+            if (first.games > 0 && !deque_push(&self->deque, first)) chunk += first.games;
+            if (!deque_push(&self->deque, second)) chunk += second.games;
+            task.games = chunk;
+        }
+
+        run_chunk(self, task.job, task.games);
+    }
+
+    return NULL;
+}
+
+/**
+ * Runs the jobs on a work-stealing pool; see scheduler.h.
+ */
+bool scheduler_run(SimJob* jobs, int num_jobs, const SchedulerOptions* options, SchedulerReport* report) {
+    if (!jobs || num_jobs <= 0 || !options || options->num_workers <= 0) return false;
+
+    Scheduler scheduler;
+    memset(&scheduler, 0, sizeof(scheduler));
+    scheduler.jobs = jobs;
+    scheduler.num_workers = options->num_workers;
+    scheduler.progress = options->progress;
+    scheduler.states = calloc(num_jobs, sizeof(JobState));
+    scheduler.workers = calloc(options->num_workers, sizeof(SchedWorker));
+    pthread_t* threads = calloc(options->num_workers, sizeof(pthread_t));
+
+    bool ok = scheduler.states && scheduler.workers && threads;
+
+    // One roll buffer per worker, large enough for every job's board
+    const Board* largest = NULL;
+    for (int j = 0; j < num_jobs; j++) {
+        if (jobs[j].board && (!largest || jobs[j].board->size > largest->size)) largest = jobs[j].board;
+    }
+
+    int initialized = 0;
+    for (int i = 0; ok && i < scheduler.num_workers; i++) {
+        SchedWorker* worker = &scheduler.workers[i];
+        worker->scheduler = &scheduler;
+        worker->index = i;
+        dice_rng_seed(&worker->rng, options->seed + (uint64_t)i * 0x9E3779B97F4A7C15ULL);
+        ok = deque_init(&worker->deque);
+        if (ok) initialized++;
+        if (ok) ok = game_result_init(&worker->result, largest);
+    }
+
+    // Hand out whole jobs round-robin; stealing spreads them from there
+    uint64_t total = 0;
+    for (int j = 0; ok && j < num_jobs; j++) {
+        jobs[j].wins = jobs[j].total_moves = 0;
+        jobs[j].shortest = 0;
+        if (!jobs[j].board || jobs[j].num_games == 0) continue;
+
+        Task task = { j, jobs[j].num_games };
+        ok = deque_push(&scheduler.workers[j % scheduler.num_workers].deque, task);
+        total += jobs[j].num_games;
+    }
+    atomic_init(&scheduler.remaining, ok ? total : 0);
+
+    struct timespec started, ended;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    int launched = 0;
+    for (int i = 0; ok && i < scheduler.num_workers; i++) {
+        if (pthread_create(&threads[i], NULL, sched_worker_main, &scheduler.workers[i]) != 0) break;
+        launched++;
+    }
+    if (ok && launched == 0) {
+        ok = false; // Without any thread nobody would drain the deques
+    }
+    for (int i = 0; i < launched; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ended);
+
+    if (ok) {
+        for (int j = 0; j < num_jobs; j++) {
+            jobs[j].wins = atomic_load(&scheduler.states[j].wins);
+            jobs[j].total_moves = atomic_load(&scheduler.states[j].total_moves);
+            jobs[j].shortest = atomic_load(&scheduler.states[j].shortest);
+        }
+        if (report) {
+            memset(report, 0, sizeof(*report));
+            report->wall_seconds = timing_seconds_between(&started, &ended);
+            for (int i = 0; i < launched; i++) {
+                report->busy_seconds += scheduler.workers[i].busy_seconds;
+                report->tasks += scheduler.workers[i].tasks;
+                report->steals += scheduler.workers[i].steals;
+            }
+        }
+    }
+
+    for (int i = 0; i < initialized; i++) {
+        deque_free(&scheduler.workers[i].deque);
+        game_result_free(&scheduler.workers[i].result);
+    }
+    free(scheduler.states);
+    free(scheduler.workers);
+    free(threads);
+    return ok;
+}
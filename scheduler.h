@@ -0,0 +1,62 @@
+#pragma once
+
+#include "board.h"
+#include "progress.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHEDULER_TARGET_TASK_NS 2000000ULL  // Aim for ~2 ms of work per task
+#define SCHEDULER_PROBE_GAMES    64          // Chunk size before a job's cost is known
+
+/**
+ * One simulation job: a board, a die and a number of games.
+ * The result fields are filled in by scheduler_run().
+ */
+typedef struct {
+    const Board* board;
+    int die_faces;
+    bool use_non_uniform;
+    const int* probabilities;
+    uint64_t num_games;
+
+    uint64_t wins;          // Games that reached the final square
+    uint64_t total_moves;   // Sum of moves over won games
+    int shortest;           // Fewest moves of a won game (0 if none)
+} SimJob;
+
+/**
+ * Settings for scheduler_run().
+ */
+typedef struct {
+    int num_workers;      // Worker threads (each owns a task deque)
+    uint64_t seed;        // Base seed; worker i uses a stream derived from seed and i
+    Progress* progress;   // Optional progress reporter, updated once per task (or NULL)
+} SchedulerOptions;
+
+/**
+ * How the work was spread over the workers.
+ */
+typedef struct {
+    double wall_seconds;    // Whole run
+    double busy_seconds;    // Summed simulation time of all workers
+    uint64_t tasks;         // Chunks executed
+    uint64_t steals;        // Tasks taken from another worker's deque
+} SchedulerReport;
+
+/**
+ * Runs a set of simulation jobs on a pool of work-stealing workers.
+ *
+ * Jobs are cut into game-chunk tasks lazily: a worker that pops a task
+ * larger than one chunk runs one chunk and pushes the rest back as two
+ * halves, which idle workers can steal from the other end of its deque.
+ * The chunk size of each job adapts to the measured time per game so that
+ * one task takes about SCHEDULER_TARGET_TASK_NS, whether games average
+ * 10 moves or 300.
+ *
+ * @param jobs Array of jobs; results are written back into each entry.
+ * @param num_jobs Number of jobs.
+ * @param options Worker count and seed.
+ * @param report Optional output for scheduling statistics (may be NULL).
+ * @return true on success, false on invalid parameters or thread/allocation failure.
+ */
+bool scheduler_run(SimJob* jobs, int num_jobs, const SchedulerOptions* options, SchedulerReport* report);
@@ -0,0 +1,791 @@
+#define _POSIX_C_SOURCE 200809L  // for fdopen(), clock_gettime()
+
+#include "server.h"
+#include "board.h"
+#include "config.h"
+#include "analysis.h"
+#include "dice.h"
+#include "fnv.h"
+#include "graph.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "timing.h"
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_JOB_LINE     1024
+#define MAX_JOB_ID       64
+#define MAX_CONFIG_PATH  256
+#define MAX_CONFIG_BYTES (16 << 20)  // Refuse config files larger than 16 MiB
+
+/**
+ * A board that has been parsed and checked by the preflight analysis,
+ * shared by all jobs that use the same configuration contents and die
+ * (faces and weights, which the verdict depends on).
+ * The graph is only needed for the analysis and is not kept.
+ */
+typedef struct CompiledBoard {
+    uint64_t key;                 // Hash of the config contents, die faces and weights
+    Board board;
+    BoardHealth health;           // Preflight verdict for that die
+    int refs;                     // Jobs currently using this entry
+    struct CompiledBoard* prev;   // LRU list neighbours, most recent first
+    struct CompiledBoard* next;
+} CompiledBoard;
+
+/**
+ * LRU cache of compiled boards. Lookups scan the list, which is cheaper
+ * than hashing for the few dozen entries the cache holds.
+ */
+typedef struct {
+    CompiledBoard* head;
+    CompiledBoard* tail;
+    int count;
+    int capacity;
+    pthread_mutex_t lock;
+} BoardCache;
+
+/**
+ * Destination of job results for one client.
+ * `pending` counts jobs that were queued but whose result is not written yet.
+ */
+typedef struct {
+    FILE* out;
+    int pending;
+    pthread_mutex_t lock;
+    pthread_cond_t idle;
+} ResultSink;
+
+/**
+ * One parsed job request.
+ */
+typedef struct {
+    ResultSink* sink;             // Client the result goes to
+    char id[MAX_JOB_ID];
+    char config_path[MAX_CONFIG_PATH];
+    int die_faces;
+    uint64_t num_games;
+    bool use_non_uniform;
+    int probabilities[MAX_DIE_FACES];
+} Job;
+
+/**
+ * Bounded FIFO of pending jobs shared between the reader and the workers.
+ */
+typedef struct {
+    Job jobs[SERVER_QUEUE_CAPACITY];
+    int head;
+    int count;
+    bool shutting_down;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} JobQueue;
+
+typedef struct {
+    BoardCache cache;
+    JobQueue queue;
+} Server;
+
+typedef struct {
+    Server* server;
+    int index;
+} WorkerArgs;
+
+/**
+ * A socket client, handed to its own reader thread.
+ */
+typedef struct {
+    Server* server;
+    FILE* in;
+    FILE* out;
+} Connection;
+
+/**
+ * Reads a whole file into a newly allocated buffer.
+ * Returns NULL if the file cannot be read or is larger than MAX_CONFIG_BYTES.
+ */
+static char* read_file(const char* path, size_t* length) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size <= 0 || size > MAX_CONFIG_BYTES || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    char* data = malloc((size_t)size);
+    size_t n = data ? fread(data, 1, (size_t)size, file) : 0;
+    fclose(file);
+
+    if (n == 0) {
+        free(data);
+        return NULL;
+    }
+
+    *length = n;
+    return data;
+}
+
+static void cache_unlink(BoardCache* cache, CompiledBoard* entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void cache_push_front(BoardCache* cache, CompiledBoard* entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head) cache->head->prev = entry;
+    cache->head = entry;
+    if (!cache->tail) cache->tail = entry;
+}
+
+/**
+ * Releases a compiled board and everything it owns.
+ */
+static void compiled_free(CompiledBoard* entry) {
+    board_free(&entry->board);
+    free(entry);
+}
+
+/**
+ * Evicts least recently used entries that no job is using until the cache
+ * fits its capacity. Must be called with the cache lock held.
+ */
+static void cache_trim(BoardCache* cache) {
+    CompiledBoard* entry = cache->tail;
+    while (cache->count > cache->capacity && entry) {
+        CompiledBoard* prev = entry->prev;
+        if (entry->refs == 0) {
+            cache_unlink(cache, entry);
+            compiled_free(entry);
+            cache->count--;
+        }
+        entry = prev;
+    }
+}
+
+/**
+ * Returns a referenced cache entry for the given config contents and die,
+ * compiling it on a miss. Returns NULL if the config is invalid.
+ */
+static CompiledBoard* cache_acquire(BoardCache* cache, const char* data, size_t length, int die_faces,
+                                    bool use_non_uniform, const int* probabilities, bool* hit) {
+    uint64_t key = fnv_hash_bytes(FNV_OFFSET_BASIS, data, length);
+    key = fnv_hash_bytes(key, &die_faces, sizeof(die_faces));
+    if (use_non_uniform) key = fnv_hash_bytes(key, probabilities, die_faces * sizeof(int));
+
+    pthread_mutex_lock(&cache->lock);
+    for (CompiledBoard* entry = cache->head; entry; entry = entry->next) {
+        if (entry->key == key) {
+            cache_unlink(cache, entry);
+            cache_push_front(cache, entry);
+            entry->refs++;
+            pthread_mutex_unlock(&cache->lock);
+            *hit = true;
+            return entry;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // Compile outside the lock so other workers are not blocked
+    CompiledBoard* fresh = calloc(1, sizeof(CompiledBoard));
+    if (!fresh) return NULL;
+    if (!load_board_from_buffer(&fresh->board, data, length)) {
+        free(fresh);
+        return NULL;
+    }
+
+    Graph graph;
+    BoardAnalysis analysis;
+    fresh->health = graph_build(&graph, &fresh->board, die_faces) &&
+                    graph_analyze(&graph, &fresh->board, die_faces, use_non_uniform, probabilities, &analysis)
+                  ? analysis.health : BOARD_BROKEN;
+    graph_free(&graph);
+    fresh->key = key;
+    fresh->refs = 1;
+
+    pthread_mutex_lock(&cache->lock);
+    for (CompiledBoard* entry = cache->head; entry; entry = entry->next) {
+        if (entry->key == key) {
+            // Another worker compiled the same board meanwhile: use theirs
+            entry->refs++;
+            pthread_mutex_unlock(&cache->lock);
+            compiled_free(fresh);
+            *hit = true;
+            return entry;
+        }
+    }
+    cache_push_front(cache, fresh);
+    cache->count++;
+    cache_trim(cache);
+    pthread_mutex_unlock(&cache->lock);
+
+    *hit = false;
+    return fresh;
+}
+
+static void cache_release(BoardCache* cache, CompiledBoard* entry) {
+    pthread_mutex_lock(&cache->lock);
+    entry->refs--;
+    cache_trim(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static void cache_free(BoardCache* cache) {
+    CompiledBoard* entry = cache->head;
+    while (entry) {
+        CompiledBoard* next = entry->next;
+        compiled_free(entry);
+        entry = next;
+    }
+    cache->head = cache->tail = NULL;
+    cache->count = 0;
+}
+
+/**
+ * Writes one result line for a client and marks the job as done.
+ */
+static void sink_write(ResultSink* sink, const char* line) {
+    pthread_mutex_lock(&sink->lock);
+    fputs(line, sink->out);
+    fflush(sink->out);
+    sink->pending--;
+    if (sink->pending == 0) pthread_cond_broadcast(&sink->idle);
+    pthread_mutex_unlock(&sink->lock);
+}
+
+/**
+ * Reads one line into `line`. A line that does not fit is consumed up to its
+ * newline and reported through `too_long`, so its tail is never taken for
+ * a job of its own. Returns false at end of input.
+ */
+static bool read_job_line(FILE* in, char* line, size_t size, bool* too_long) {
+    if (!fgets(line, (int)size, in)) return false;
+
+    *too_long = false;
+    size_t length = strlen(line);
+    if (length == size - 1 && line[length - 1] != '\n') {
+        // Buffer full: the line is too long unless it ends right here
+        int c = fgetc(in);
+        *too_long = c != EOF && c != '\n';
+        while (c != EOF && c != '\n') c = fgetc(in);
+    }
+    return true;
+}
+
+/**
+ * Parses a job line. Returns false (with a message) if the line is malformed.
+ */
+/**
+ * Parses the next whitespace-separated decimal integer at *cursor and checks
+ * that it lies in [min, max]. Advances the cursor past it on success.
+ * Unlike sscanf("%d"), out-of-range input is detected instead of being
+ * undefined behaviour.
+ */
+static bool parse_number(const char** cursor, long long min, long long max, long long* value) {
+    char* end;
+    errno = 0;
+    long long parsed = strtoll(*cursor, &end, 10);
+    if (end == *cursor || errno == ERANGE || parsed < min || parsed > max) return false;
+    if (*end != '\0' && !isspace((unsigned char)*end)) return false;
+    *cursor = end;
+    *value = parsed;
+    return true;
+}
+
+/**
+ * Returns true if only whitespace is left at `cursor`.
+ */
+static bool at_end(const char* cursor) {
+    while (isspace((unsigned char)*cursor)) cursor++;
+    return *cursor == '\0';
+}
+
+static bool parse_job(const char* line, Job* job, const char** error) {
+    int consumed = 0;
+    long long value;
+    memset(job, 0, sizeof(*job));
+
+    if (sscanf(line, "%63s %255s%n", job->id, job->config_path, &consumed) != 2 || at_end(line + consumed)) {
+        *error = "expected: <id> <config_file> <die_faces> <num_games> [weights...]";
+        return false;
+    }
+
+    const char* cursor = line + consumed;
+    if (!parse_number(&cursor, 1, MAX_DIE_FACES, &value)) {
+        *error = "invalid number of die faces";
+        return false;
+    }
+    job->die_faces = (int)value;
+    if (!parse_number(&cursor, 1, LLONG_MAX, &value)) {
+        *error = "invalid number of games";
+        return false;
+    }
+    job->num_games = (uint64_t)value;
+
+    int weights = 0;
+    while (!at_end(cursor)) {
+        if (weights == job->die_faces) {
+            *error = "more weights than die faces";
+            return false;
+        }
+        if (!parse_number(&cursor, 1, INT_MAX, &value)) {
+            *error = "weights must be one positive integer per die face";
+            return false;
+        }
+        job->probabilities[weights++] = (int)value;
+    }
+
+    if (weights > 0) {
+        if (weights != job->die_faces) {
+            *error = "weights must be one positive integer per die face";
+            return false;
+        }
+        if (!dice_validate_probabilities(job->probabilities, weights)) {
+            *error = "weights must sum to at most 2147483647";
+            return false;
+        }
+        job->use_non_uniform = true;
+    }
+    return true;
+}
+
+/**
+ * Reads the job's config and returns its compiled board from the cache.
+ * Returns NULL with an error message if the board cannot be used.
+ */
+static CompiledBoard* compile_job(BoardCache* cache, const Job* job, bool* hit, const char** error) {
+    size_t length = 0;
+    char* data = read_file(job->config_path, &length);
+    if (!data) {
+        *error = "cannot read config";
+        return NULL;
+    }
+
+    CompiledBoard* compiled = cache_acquire(cache, data, length, job->die_faces,
+                                            job->use_non_uniform, job->probabilities, hit);
+    free(data);
+    if (!compiled) {
+        *error = "invalid board config";
+        return NULL;
+    }
+
+    if (compiled->health == BOARD_BROKEN) {
+        cache_release(cache, compiled);
+        *error = "unwinnable board";
+        return NULL;
+    }
+    return compiled;
+}
+
+/**
+ * Runs one job against the cache and streams its result line.
+ */
+static void run_job(Server* server, const Job* job, DiceRng* rng) {
+    char line[MAX_JOB_LINE];
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    bool hit = false;
+    const char* error = NULL;
+    CompiledBoard* compiled = compile_job(&server->cache, job, &hit, &error);
+    if (!compiled) {
+        snprintf(line, sizeof(line), "%s error %s %s\n", job->id, error, job->config_path);
+        sink_write(job->sink, line);
+        return;
+    }
+
+    uint64_t total_moves = 0;
+    uint64_t wins = 0;
+    int shortest = 0;
+    GameResult result;
+    if (!game_result_init(&result, &compiled->board)) {
+        cache_release(&server->cache, compiled);
+        snprintf(line, sizeof(line), "%s error out of memory %s\n", job->id, job->config_path);
+        sink_write(job->sink, line);
+        return;
+    }
+
+    for (uint64_t i = 0; i < job->num_games; i++) {
+        simulate_game_rng(&compiled->board, job->die_faces, &result,
+                          job->use_non_uniform, job->probabilities, rng);
+        if (result.won) {
+            total_moves += result.move_count;
+            if (wins == 0 || result.move_count < shortest) shortest = result.move_count;
+            wins++;
+        }
+    }
+
+    game_result_free(&result);
+    cache_release(&server->cache, compiled);
+
+    double avg = (wins > 0) ? (double)total_moves / wins : 0.0;
+    snprintf(line, sizeof(line), "%s ok games=%llu wins=%llu avg=%.4f shortest=%d cache=%s us=%.0f\n",
+             job->id, (unsigned long long)job->num_games, (unsigned long long)wins, avg, shortest,
+             hit ? "hit" : "miss",
+             timing_seconds_since(&started) * 1e6);
+    sink_write(job->sink, line);
+}
+
+static void* worker_main(void* arg) {
+    WorkerArgs* args = arg;
+    Server* server = args->server;
+    JobQueue* queue = &server->queue;
+
+    DiceRng rng;
+    dice_rng_seed(&rng, ((uint64_t)time(NULL) << 16) ^ (uint64_t)args->index);
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->count == 0 && !queue->shutting_down) {
+            pthread_cond_wait(&queue->not_empty, &queue->lock);
+        }
+        if (queue->count == 0) {
+            pthread_mutex_unlock(&queue->lock);
+            break; // Shutting down and nothing left to do
+        }
+
+        Job job = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) % SERVER_QUEUE_CAPACITY;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+        pthread_mutex_unlock(&queue->lock);
+
+        run_job(server, &job, &rng);
+    }
+
+    return NULL;
+}
+
+static void queue_push(JobQueue* queue, const Job* job) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == SERVER_QUEUE_CAPACITY) {
+        pthread_cond_wait(&queue->not_full, &queue->lock);
+    }
+    queue->jobs[(queue->head + queue->count) % SERVER_QUEUE_CAPACITY] = *job;
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * Reads job lines from `in` until end of input, writing results to `out`.
+ * Jobs go to the shared worker pool; several streams may be served at once.
+ * Returns only after every job from this stream has been answered.
+ */
+static void serve_stream(Server* server, FILE* in, FILE* out) {
+    ResultSink sink = { out, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+    char line[MAX_JOB_LINE];
+    bool too_long = false;
+
+    while (read_job_line(in, line, sizeof(line), &too_long)) {
+        char first[2];
+        if (line[0] == '#' || sscanf(line, "%1s", first) != 1) continue;
+
+        Job job;
+        const char* error = NULL;
+        pthread_mutex_lock(&sink.lock);
+        sink.pending++;
+        pthread_mutex_unlock(&sink.lock);
+
+        if (!too_long && parse_job(line, &job, &error)) {
+            job.sink = &sink;
+            queue_push(&server->queue, &job);
+        } else {
+            if (too_long) error = "job line too long";
+            char reply[MAX_JOB_LINE];
+            char id[MAX_JOB_ID] = "?";
+            sscanf(line, "%63s", id);
+            snprintf(reply, sizeof(reply), "%s error %s\n", id, error);
+            sink_write(&sink, reply);
+        }
+    }
+
+    pthread_mutex_lock(&sink.lock);
+    while (sink.pending > 0) {
+        pthread_cond_wait(&sink.idle, &sink.lock);
+    }
+    pthread_mutex_unlock(&sink.lock);
+    pthread_mutex_destroy(&sink.lock);
+    pthread_cond_destroy(&sink.idle);
+}
+
+/**
+ * Serves one socket client until it closes its side of the connection.
+ */
+static void* connection_main(void* arg) {
+    Connection* connection = arg;
+    serve_stream(connection->server, connection->in, connection->out);
+    fclose(connection->in);
+    fclose(connection->out);
+    free(connection);
+    return NULL;
+}
+
+/**
+ * Accepts clients on a Unix socket and serves each on its own reader thread,
+ * so jobs from all connected clients share the worker pool.
+ */
+static int serve_socket(Server* server, const char* path) {
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("Failed to create server socket");
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "❌ Socket path too long: %s\n", path);
+        close(listener);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+    unlink(path); // Remove a stale socket from a previous run
+
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        perror("Failed to listen on server socket");
+        close(listener);
+        return 1;
+    }
+
+    fprintf(stderr, "🛰️ Listening on %s\n", path);
+
+    for (;;) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) continue;
+
+        int write_fd = dup(client);
+        FILE* in = fdopen(client, "r");
+        FILE* out = (write_fd >= 0) ? fdopen(write_fd, "w") : NULL;
+        if (!in || !out) {
+            if (in) fclose(in); else close(client);
+            if (out) fclose(out); else if (write_fd >= 0) close(write_fd);
+            continue;
+        }
+
+        // Detached: the reader thread owns the connection and frees it when done
+        Connection* connection = malloc(sizeof(Connection));
+        pthread_t thread;
+        pthread_attr_t attributes;
+        bool started = false;
+        if (connection && pthread_attr_init(&attributes) == 0) {
+            *connection = (Connection){ server, in, out };
+            pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+            started = pthread_create(&thread, &attributes, connection_main, connection) == 0;
+            pthread_attr_destroy(&attributes);
+        }
+        if (!started) {
+            fprintf(stderr, "⚠️ Could not start a reader for a new client\n");
+            free(connection);
+            fclose(in);
+            fclose(out);
+        }
+    }
+}
+
+int server_run(const ServerOptions* options) {
+    if (!options) return 1;
+
+    int num_workers = options->num_workers > 0 ? options->num_workers : SERVER_DEFAULT_WORKERS;
+    int cache_capacity = options->cache_capacity > 0 ? options->cache_capacity : SERVER_DEFAULT_CACHE_SIZE;
+
+    Server* server = calloc(1, sizeof(Server));
+    pthread_t* threads = calloc(num_workers, sizeof(pthread_t));
+    WorkerArgs* args = calloc(num_workers, sizeof(WorkerArgs));
+    if (!server || !threads || !args) {
+        free(server);
+        free(threads);
+        free(args);
+        return 1;
+    }
+
+    server->cache.capacity = cache_capacity;
+    pthread_mutex_init(&server->cache.lock, NULL);
+    pthread_mutex_init(&server->queue.lock, NULL);
+    pthread_cond_init(&server->queue.not_empty, NULL);
+    pthread_cond_init(&server->queue.not_full, NULL);
+
+    // A client that disconnects early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    int started = 0;
+    for (int i = 0; i < num_workers; i++) {
+        args[i].server = server;
+        args[i].index = i;
+        if (pthread_create(&threads[i], NULL, worker_main, &args[i]) != 0) break;
+        started++;
+    }
+
+    int status = 0;
+    if (started == 0) {
+        fprintf(stderr, "❌ Failed to start worker threads\n");
+        status = 1;
+    } else if (options->socket_path) {
+        status = serve_socket(server, options->socket_path);
+    } else {
+        serve_stream(server, stdin, stdout);
+    }
+
+    pthread_mutex_lock(&server->queue.lock);
+    server->queue.shutting_down = true;
+    pthread_cond_broadcast(&server->queue.not_empty);
+    pthread_mutex_unlock(&server->queue.lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    cache_free(&server->cache);
+    pthread_mutex_destroy(&server->cache.lock);
+    pthread_mutex_destroy(&server->queue.lock);
+    pthread_cond_destroy(&server->queue.not_empty);
+    pthread_cond_destroy(&server->queue.not_full);
+    free(server);
+    free(threads);
+    free(args);
+    return status;
+}
+
+/**
+ * One line of a batch file, with its compiled board or the reason it failed.
+ */
+typedef struct {
+    Job job;
+    CompiledBoard* compiled;
+    const char* error;
+    int sim_index;  // Index into the SimJob array, -1 on error
+} BatchEntry;
+
+int server_run_batch(const char* jobs_file, const ServerOptions* options) {
+    if (!jobs_file || !options) return 1;
+
+    FILE* in = fopen(jobs_file, "r");
+    if (!in) {
+        perror("Failed to open jobs file");
+        return 1;
+    }
+
+    BoardCache cache;
+    memset(&cache, 0, sizeof(cache));
+    cache.capacity = options->cache_capacity > 0 ? options->cache_capacity : SERVER_DEFAULT_CACHE_SIZE;
+    pthread_mutex_init(&cache.lock, NULL);
+
+    BatchEntry* entries = NULL;
+    int count = 0, capacity = 0, valid = 0;
+    char line[MAX_JOB_LINE];
+    bool too_long = false;
+    bool ok = true;
+
+    while (ok && read_job_line(in, line, sizeof(line), &too_long)) {
+        char first[2];
+        if (line[0] == '#' || sscanf(line, "%1s", first) != 1) continue;
+
+        if (count == capacity) {
+            int grown_capacity = capacity ? capacity * 2 : 64;
+            BatchEntry* grown = realloc(entries, grown_capacity * sizeof(BatchEntry));
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            entries = grown;
+            capacity = grown_capacity;
+        }
+
+        BatchEntry* entry = &entries[count++];
+        entry->compiled = NULL;
+        entry->error = NULL;
+        entry->sim_index = -1;
+
+        bool hit;
+        if (too_long) {
+            entry->error = "job line too long";
+            strcpy(entry->job.id, "?");
+            sscanf(line, "%63s", entry->job.id);
+        } else if (parse_job(line, &entry->job, &entry->error)) {
+            entry->compiled = compile_job(&cache, &entry->job, &hit, &entry->error);
+            if (entry->compiled) entry->sim_index = valid++;
+        } else {
+            strcpy(entry->job.id, "?");
+            sscanf(line, "%63s", entry->job.id);
+        }
+    }
+    fclose(in);
+
+    SimJob* sims = (ok && valid > 0) ? calloc(valid, sizeof(SimJob)) : NULL;
+    SchedulerReport report;
+    uint64_t total_games = 0;
+    if (sims) {
+        for (int i = 0; i < count; i++) {
+            if (entries[i].sim_index < 0) continue;
+            SimJob* sim = &sims[entries[i].sim_index];
+            sim->board = &entries[i].compiled->board;
+            sim->die_faces = entries[i].job.die_faces;
+            sim->use_non_uniform = entries[i].job.use_non_uniform;
+            sim->probabilities = entries[i].job.probabilities;
+            sim->num_games = entries[i].job.num_games;
+            total_games += sim->num_games;
+        }
+
+        Progress progress;
+        bool reporting = options->progress_interval > 0.0 &&
+                         progress_start(&progress, total_games, options->progress_interval, stderr);
+        SchedulerOptions scheduler_options = {
+            options->num_workers > 0 ? options->num_workers : SERVER_DEFAULT_WORKERS,
+            (uint64_t)time(NULL),
+            reporting ? &progress : NULL,
+        };
+        ok = scheduler_run(sims, valid, &scheduler_options, &report);
+        if (reporting) progress_stop(&progress);
+    }
+
+    for (int i = 0; ok && i < count; i++) {
+        const BatchEntry* entry = &entries[i];
+        if (entry->sim_index < 0) {
+            printf("%s error %s\n", entry->job.id, entry->error);
+            continue;
+        }
+        const SimJob* sim = &sims[entry->sim_index];
+        double avg = sim->wins ? (double)sim->total_moves / sim->wins : 0.0;
+        printf("%s ok games=%llu wins=%llu avg=%.4f shortest=%d\n", entry->job.id,
+               (unsigned long long)sim->num_games, (unsigned long long)sim->wins, avg, sim->shortest);
+    }
+
+    if (ok && sims) {
+        int workers = options->num_workers > 0 ? options->num_workers : SERVER_DEFAULT_WORKERS;
+        double utilisation = report.wall_seconds > 0
+                           ? 100.0 * report.busy_seconds / (report.wall_seconds * workers) : 0.0;
+        fprintf(stderr, "⚙️ %d jobs in %.3f s on %d workers: %llu tasks, %llu steals, %.0f%% busy\n",
+                valid, report.wall_seconds, workers, (unsigned long long)report.tasks,
+                (unsigned long long)report.steals, utilisation);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (entries[i].compiled) cache_release(&cache, entries[i].compiled);
+    }
+    cache_free(&cache);
+    pthread_mutex_destroy(&cache.lock);
+    free(entries);
+    free(sims);
+
+    if (!ok) fprintf(stderr, "❌ Batch run failed\n");
+    return ok ? 0 : 1;
+}
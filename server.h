@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+
+#define SERVER_DEFAULT_WORKERS    4    // Worker threads when none are requested
+#define SERVER_DEFAULT_CACHE_SIZE 64   // Compiled boards kept in the LRU cache
+#define SERVER_QUEUE_CAPACITY     256  // Pending jobs before the reader blocks
+
+/**
+ * Settings for the long-running job server.
+ */
+typedef struct {
+    const char* socket_path;  // Unix socket to listen on, or NULL for stdin/stdout
+    int num_workers;          // Number of simulation worker threads
+    int cache_capacity;       // Maximum number of compiled boards kept in memory
+    double progress_interval; // Batch mode: seconds between progress lines on stderr (0 = off)
+} ServerOptions;
+
+/**
+ * Runs the job server until its input ends (stdin mode) or forever (socket mode).
+ *
+ * Each input line is one job:
+ *   <id> <config_file> <die_faces> <num_games> [<weight_1> ... <weight_faces>]
+ * Weights are optional; when given, a non-uniform die is used.
+ * Blank lines and lines starting with '#' are ignored, and lines longer than
+ * the server's line limit are rejected as a whole.
+ *
+ * In socket mode every client gets its own reader thread, so jobs from all
+ * connected clients are served concurrently by the same worker pool.
+ * Jobs are dispatched to a pool of worker threads, and one line per job is
+ * streamed back to its client as soon as it finishes (so not necessarily in
+ * input order):
+ *   <id> ok games=<n> wins=<n> avg=<moves> shortest=<moves> cache=<hit|miss> us=<time>
+ *   <id> error <message>
+ *
+ * Boards are compiled (parsed and checked by the preflight analysis) once and
+ * kept in an LRU cache keyed by a hash of the configuration file contents and
+ * the die (faces and weights, since the preflight verdict depends on both),
+ * so repeated jobs only pay for reading the file and the simulation itself.
+ *
+ * @param options Server settings.
+ * @return 0 on clean shutdown, non-zero if the server could not start.
+ */
+int server_run(const ServerOptions* options);
+
+/**
+ * Runs every job of a job file (same line format as server_run()) as one
+ * batch on the work-stealing scheduler, then prints one result line per job
+ * in input order:
+ *   <id> ok games=<n> wins=<n> avg=<moves> shortest=<moves>
+ *   <id> error <message>
+ * Mixed cheap and expensive jobs are balanced across `num_workers` threads.
+ *
+ * @param jobs_file Path of the job file.
+ * @param options Worker count, cache size and progress interval (socket_path is ignored).
+ * @return 0 on success, non-zero on failure.
+ */
+int server_run_batch(const char* jobs_file, const ServerOptions* options);
@@ -1,7 +1,54 @@
 #include "simulator.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+/**
+ * Move cap for a board: proportional to its size, so large boards can
+ * still be finished.
+ */
+int simulate_move_cap(const Board* board) {
+    if (!board || board->size <= MOVE_CAP_MIN / MOVE_CAP_PER_SQUARE) return MOVE_CAP_MIN;
+    return board->size * MOVE_CAP_PER_SQUARE;
+}
+
+/**
+ * Allocates a roll buffer holding the board's move cap.
+ */
+bool game_result_init(GameResult* result, const Board* board) {
+    if (!result) return false;
+    memset(result, 0, sizeof(*result));
+    result->capacity = simulate_move_cap(board);
+    result->moves = malloc((size_t)result->capacity);
+    if (!result->moves) {
+        result->capacity = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Releases the roll buffer and resets the result.
+ */
+void game_result_free(GameResult* result) {
+    if (!result) return;
+    free(result->moves);
+    memset(result, 0, sizeof(*result));
+}
+
+/**
+ * Copies the counters and the rolls actually made, not the whole buffer.
+ */
+bool game_result_copy(GameResult* to, const GameResult* from) {
+    if (!to || !from || from->move_count > to->capacity) return false;
+    to->move_count = from->move_count;
+    to->turn_count = from->turn_count;
+    to->die_faces = from->die_faces;
+    to->won = from->won;
+    memcpy(to->moves, from->moves, (size_t)from->move_count);
+    return true;
+}
+
 /**
  * Simulates a single game of Snakes and Ladders.
  * Records all die rolls and whether the game was won.
@@ -19,40 +66,152 @@ void simulate_game(
     bool use_non_uniform,
     const int* probabilities
 ) {
-    if (!board || !result) return;
+    simulate_game_rng(board, die_faces, result, use_non_uniform, probabilities, dice_default_rng());
+}
 
+/**
+ * Game loop shared by all rule variants. `rules`, `use_non_uniform` and
+ * `count_occupancy` are compile-time constants in every caller below, so
+ * after inlining the compiler drops the branches of the rules that are not
+ * active and each kernel only contains the work its rule set needs.
+ */
+static inline __attribute__((always_inline)) void game_kernel(
+    const Board* board,
+    int die_faces,
+    GameResult* result,
+    const int* probabilities,
+    DiceRng* rng,
+    uint64_t* occupancy,
+    const RuleSet rules,
+    const bool use_non_uniform,
+    const bool count_occupancy
+) {
     int position = 1;       // Starting square
     int moves = 0;          // Number of rolls taken
+    int turns = 0;          // Number of turns taken
+    int streak = 0;         // Highest-face rolls in a row
+    const int max_moves = simulate_move_cap(board);
+    uint8_t* history = result->moves;
 
     result->won = false;
     result->move_count = 0;
-    memset(result->moves, 0, sizeof(result->moves));  // Clear move history
+    result->die_faces = die_faces;
 
     // Run the simulation until win or max moves reached
-    while (moves < MAX_MOVES_TRACKED) {
+    while (moves < max_moves) {
         // Roll the die (fair or non-uniform)
         int roll = use_non_uniform
-                 ? dice_roll_non_uniform(die_faces, probabilities)
-                 : dice_roll_uniform(die_faces);
+                 ? dice_rng_roll_non_uniform(rng, die_faces, probabilities)
+                 : dice_rng_roll_uniform(rng, die_faces);
 
-        result->moves[moves++] = roll;  // Store roll
-        position += roll;
+        history[moves++] = (uint8_t)roll;  // Store roll
 
-        // If roll exceeds board, stay in place
-        if (position > board->size) {
-            position -= roll;
-        } else {
-            position = board_apply_jump(board, position); // Apply snake or ladder
+        // The streak carries across turns; see RULE_MAX_STREAK in rules.h
+        if (rules & RULE_THREE_MAX_HOME) {
+            streak = (roll == die_faces) ? streak + 1 : 0;
+            if (streak == RULE_MAX_STREAK) {
+                position = 1;  // Sent home, turn is over
+                streak = 0;
+                turns++;
+                if (count_occupancy) occupancy[position]++;
+                continue;
+            }
         }
 
+        // Overshoot rule, then snake or ladder
+        int target = rules_target(rules, board->size, position, roll);
+        if (target != position) {
+            position = board_apply_jump(board, target);
+        }
+        if (count_occupancy) occupancy[position]++;
+
         // Check for win
         if (position == board->size) {
             result->won = true;
+            turns++;
             break;
         }
+
+        if (!(rules & RULE_REROLL_ON_MAX) || roll != die_faces) {
+            turns++;
+        }
     }
 
     result->move_count = moves;
+    result->turn_count = turns;
+}
+
+typedef void (*GameKernel)(const Board*, int, GameResult*, const int*, DiceRng*, uint64_t*);
+
+// One specialised kernel per (rule set, die type, occupancy counting) combination
+#define DEFINE_GAME_KERNEL(R, NAME, WEIGHTED, COUNTED)                                     \
+    static void game_kernel_##NAME##_##R(const Board* board, int die_faces,                 \
+                                         GameResult* result, const int* probabilities,      \
+                                         DiceRng* rng, uint64_t* occupancy) {               \
+        game_kernel(board, die_faces, result, probabilities, rng, occupancy,                \
+                    R, WEIGHTED, COUNTED);                                                  \
+    }
+#define DEFINE_GAME_KERNELS(R)                                \
+    DEFINE_GAME_KERNEL(R, uniform, false, false)              \
+    DEFINE_GAME_KERNEL(R, weighted, true, false)              \
+    DEFINE_GAME_KERNEL(R, uniform_counted, false, true)       \
+    DEFINE_GAME_KERNEL(R, weighted_counted, true, true)
+
+DEFINE_GAME_KERNELS(0)  DEFINE_GAME_KERNELS(1)  DEFINE_GAME_KERNELS(2)  DEFINE_GAME_KERNELS(3)
+DEFINE_GAME_KERNELS(4)  DEFINE_GAME_KERNELS(5)  DEFINE_GAME_KERNELS(6)  DEFINE_GAME_KERNELS(7)
+DEFINE_GAME_KERNELS(8)  DEFINE_GAME_KERNELS(9)  DEFINE_GAME_KERNELS(10) DEFINE_GAME_KERNELS(11)
+DEFINE_GAME_KERNELS(12) DEFINE_GAME_KERNELS(13) DEFINE_GAME_KERNELS(14) DEFINE_GAME_KERNELS(15)
+
+#define KERNEL_ROW(R) {                                                   \
+    { game_kernel_uniform_##R, game_kernel_weighted_##R },                \
+    { game_kernel_uniform_counted_##R, game_kernel_weighted_counted_##R } \
+}
+
+// Indexed by [rule set][count_occupancy][use_non_uniform]
+static const GameKernel GAME_KERNELS[RULE_COMBINATIONS][2][2] = {
+    KERNEL_ROW(0),  KERNEL_ROW(1),  KERNEL_ROW(2),  KERNEL_ROW(3),
+    KERNEL_ROW(4),  KERNEL_ROW(5),  KERNEL_ROW(6),  KERNEL_ROW(7),
+    KERNEL_ROW(8),  KERNEL_ROW(9),  KERNEL_ROW(10), KERNEL_ROW(11),
+    KERNEL_ROW(12), KERNEL_ROW(13), KERNEL_ROW(14), KERNEL_ROW(15),
+};
+
+/**
+ * Simulates a single game drawing rolls from the caller's generator.
+ * Dispatches once per game to the kernel specialised for the board's rules.
+ */
+void simulate_game_rng(
+    const Board* board,
+    int die_faces,
+    GameResult* result,
+    bool use_non_uniform,
+    const int* probabilities,
+    DiceRng* rng
+) {
+    simulate_game_counted(board, die_faces, result, use_non_uniform, probabilities, rng, NULL);
+}
+
+/**
+ * Simulates a single game and counts its landings into `occupancy`.
+ * Without counters the plain kernel runs, so counting costs nothing unless asked for.
+ */
+void simulate_game_counted(
+    const Board* board,
+    int die_faces,
+    GameResult* result,
+    bool use_non_uniform,
+    const int* probabilities,
+    DiceRng* rng,
+    uint64_t* occupancy
+) {
+    if (!board || !result || !rng || board->rules >= RULE_COMBINATIONS) return;
+    if (!result->moves || result->capacity < simulate_move_cap(board)) {
+        result->won = false;
+        result->move_count = result->turn_count = 0;
+        return;
+    }
+
+    GAME_KERNELS[board->rules][occupancy ? 1 : 0][use_non_uniform ? 1 : 0](
+        board, die_faces, result, probabilities, rng, occupancy);
 }
 
 /**
@@ -68,17 +227,18 @@ void simulate_game(
 double simulate_average_moves(
     const Board* board,
     int die_faces,
-    int num_games,
+    uint64_t num_games,
     bool use_non_uniform,
     const int* probabilities
 ) {
-    if (!board || num_games <= 0) return 0.0;
+    if (!board || num_games == 0) return 0.0;
 
-    int total_moves = 0;
-    int wins = 0;
+    uint64_t total_moves = 0;
+    uint64_t wins = 0;
+    GameResult res;
+    if (!game_result_init(&res, board)) return 0.0;
 
-    for (int i = 0; i < num_games; i++) {
-        GameResult res;
+    for (uint64_t i = 0; i < num_games; i++) {
         simulate_game(board, die_faces, &res, use_non_uniform, probabilities);
 
         if (res.won) {
@@ -87,6 +247,7 @@ double simulate_average_moves(
         }
     }
 
+    game_result_free(&res);
     if (wins == 0) return 0.0; // No wins occurred
 
     return (double)total_moves / wins;
@@ -106,26 +267,27 @@ double simulate_average_moves(
 bool simulate_shortest_win(
     const Board* board,
     int die_faces,
-    int num_games,
+    uint64_t num_games,
     bool use_non_uniform,
     const int* probabilities,
     GameResult* out_result
 ) {
-    if (!board || !out_result || num_games <= 0) return false;
+    if (!board || !out_result || num_games == 0) return false;
 
     bool found = false;
-    int min_moves = MAX_MOVES_TRACKED;
+    int min_moves = simulate_move_cap(board);
     GameResult temp;
+    if (!game_result_init(&temp, board)) return false;
 
-    for (int i = 0; i < num_games; i++) {
+    for (uint64_t i = 0; i < num_games; i++) {
         simulate_game(board, die_faces, &temp, use_non_uniform, probabilities);
 
         if (temp.won && temp.move_count < min_moves) {
             min_moves = temp.move_count;
-            *out_result = temp; // Save shortest winning result
-            found = true;
+            if (game_result_copy(out_result, &temp)) found = true; // Save shortest winning result
         }
     }
 
+    game_result_free(&temp);
     return found;
 }
@@ -4,28 +4,81 @@
 #include "graph.h"
 #include "dice.h"
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_MOVES_TRACKED (MAX_BOARD_SIZE * 2)  // Safety margin for maximum moves per game
+#define MOVE_CAP_MIN        200  // Safety margin for maximum moves per game (twice a 10x10 board)
+#define MOVE_CAP_PER_SQUARE 2    // Larger boards allow this many moves per square
+
+_Static_assert(MAX_DIE_FACES <= UINT8_MAX, "rolls must fit a byte");
 
 /**
  * Represents the result of a single game simulation.
+ * The roll buffer is sized by game_result_init() for the move cap of a board;
+ * it can be reused for any board whose move cap is not larger.
  */
 typedef struct {
     int move_count;                    // Total number of die rolls during this game
-    int moves[MAX_MOVES_TRACKED];     // Sequence of die rolls
+    int turn_count;                    // Number of turns (differs from move_count with RULE_REROLL_ON_MAX)
+    int die_faces;                     // Faces of the die that produced `moves`
+    int capacity;                      // Rolls `moves` can hold
+    uint8_t* moves;                    // Sequence of die rolls
     bool won;                          // Set to true if the player reached the final square
 } GameResult;
 
+/**
+ * Returns the maximum number of rolls a game on this board may take before
+ * it is abandoned: MOVE_CAP_PER_SQUARE per square, but at least MOVE_CAP_MIN.
+ *
+ * @param board Pointer to the game board.
+ * @return Move cap for games on the board.
+ */
+int simulate_move_cap(const Board* board);
+
+/**
+ * Allocates a roll buffer holding simulate_move_cap(board) rolls.
+ * Release it with game_result_free().
+ *
+ * @param result Result to initialize.
+ * @param board Board the result will be simulated on.
+ * @return true on success, false on allocation failure.
+ */
+bool game_result_init(GameResult* result, const Board* board);
+
+/**
+ * Releases the roll buffer of a result. Safe to call on a zeroed or already
+ * freed result.
+ *
+ * @param result Result to release.
+ */
+void game_result_free(GameResult* result);
+
+/**
+ * Copies a game into a result initialized with game_result_init(),
+ * keeping the destination's own roll buffer.
+ *
+ * @param to Destination result.
+ * @param from Source result.
+ * @return true on success, false if the game does not fit `to`.
+ */
+bool game_result_copy(GameResult* to, const GameResult* from);
+
 /**
  * Simulates one complete game of Snakes and Ladders.
  *
  * The game starts at position 1 and continues until the player either:
  * - Wins (reaches final square), or
- * - Exceeds MAX_MOVES_TRACKED (to avoid infinite loops).
+ * - Exceeds simulate_move_cap(board) rolls (to avoid infinite loops).
+ *
+ * The rule variant is taken from board->rules (see rules.h). Each rule
+ * combination runs its own specialised game loop, so unused rules cost
+ * nothing per roll.
  *
  * @param board Pointer to the game board.
  * @param die_faces Number of die faces (e.g. 6).
- * @param result Output structure to store the game's result.
+ * @param result Output structure to store the game's result, initialized
+ *               with game_result_init() for this board (or a larger one).
+ *               A result too small for the board is left as a lost game
+ *               of zero moves.
  * @param use_non_uniform Set to true to use a weighted die.
  * @param probabilities Pointer to array of probabilities for each die face (used only if non-uniform).
  */
@@ -37,12 +90,60 @@ void simulate_game(
     const int* probabilities
 );
 
+/**
+ * Simulates one complete game like simulate_game(), but draws all rolls from
+ * the given generator instead of the process-wide one. Safe to call from
+ * several threads as long as each thread uses its own generator.
+ *
+ * @param board Pointer to the game board.
+ * @param die_faces Number of die faces (e.g. 6).
+ * @param result Output structure to store the game's result.
+ * @param use_non_uniform Set to true to use a weighted die.
+ * @param probabilities Pointer to array of probabilities for each die face (used only if non-uniform).
+ * @param rng Generator owned by the calling thread.
+ */
+void simulate_game_rng(
+    const Board* board,
+    int die_faces,
+    GameResult* result,
+    bool use_non_uniform,
+    const int* probabilities,
+    DiceRng* rng
+);
+
+/**
+ * Simulates one complete game like simulate_game_rng() and also counts,
+ * per square, how often the player landed there (the square reached after
+ * each roll, snakes and ladders applied). Counting runs in its own
+ * specialised kernel; pass NULL to skip it.
+ *
+ * @param board Pointer to the game board.
+ * @param die_faces Number of die faces (e.g. 6).
+ * @param result Output structure to store the game's result.
+ * @param use_non_uniform Set to true to use a weighted die.
+ * @param probabilities Pointer to array of probabilities for each die face (used only if non-uniform).
+ * @param rng Generator owned by the calling thread.
+ * @param occupancy Per-square counters (index 1..board->size) owned by the
+ *                  calling thread, e.g. from heatmap_thread_counters(), or NULL.
+ */
+void simulate_game_counted(
+    const Board* board,
+    int die_faces,
+    GameResult* result,
+    bool use_non_uniform,
+    const int* probabilities,
+    DiceRng* rng,
+    uint64_t* occupancy
+);
+
 /**
  * Runs multiple game simulations and calculates the average number of rolls
  * required to win.
  *
  * Only successful games (i.e., games where the player reached the goal) are
- * counted towards the average.
+ * counted towards the average. Totals are kept in 64-bit integers, so runs of
+ * billions of games cannot overflow them. For progress reporting, run the
+ * games with run_result_extend() instead.
  *
  * @param board Pointer to the board.
  * @param die_faces Number of faces on the die.
@@ -54,7 +155,7 @@ void simulate_game(
 double simulate_average_moves(
     const Board* board,
     int die_faces,
-    int num_games,
+    uint64_t num_games,
     bool use_non_uniform,
     const int* probabilities
 );
@@ -69,13 +170,14 @@ double simulate_average_moves(
  * @param num_games Number of games to simulate.
  * @param use_non_uniform Use weighted die if true.
  * @param probabilities Weights for non-uniform die (if enabled).
- * @param out_result Output structure that will store the best result.
+ * @param out_result Output structure that will store the best result,
+ *                   initialized with game_result_init() for this board.
  * @return true if a winning game was found, false if all simulations failed.
  */
 bool simulate_shortest_win(
     const Board* board,
     int die_faces,
-    int num_games,
+    uint64_t num_games,
     bool use_non_uniform,
     const int* probabilities,
     GameResult* out_result
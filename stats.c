@@ -1,19 +1,45 @@
 #include "stats.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /**
- * Initializes the statistics structure by resetting all counters.
+ * Initializes the statistics structure with zeroed counters for every
+ * snake and ladder of the board.
  *
  * @param stats Pointer to the Stats structure to initialize.
+ * @param board Pointer to the board whose jumps are counted.
+ * @return true on success, false otherwise.
  */
-void stats_init(Stats* stats) {
+bool stats_init(Stats* stats, const Board* board) {
+    if (!stats) return false;
+
+    memset(stats, 0, sizeof(*stats));
+    if (!board) return false;
+
+    // One zeroed counter per snake and ladder (at least one to get a valid pointer)
+    stats->snake_hits = calloc(board->num_snakes > 0 ? board->num_snakes : 1, sizeof(uint64_t));
+    stats->ladder_hits = calloc(board->num_ladders > 0 ? board->num_ladders : 1, sizeof(uint64_t));
+    if (!stats->snake_hits || !stats->ladder_hits) {
+        stats_free(stats);
+        return false;
+    }
+    stats->num_snakes = board->num_snakes;
+    stats->num_ladders = board->num_ladders;
+    return true;
+}
+
+/**
+ * Releases the counters of a Stats structure.
+ *
+ * @param stats Pointer to the Stats structure.
+ */
+void stats_free(Stats* stats) {
     if (!stats) return;
 
-    // Set all ladder and snake hit counters to zero
-    memset(stats->snake_hits, 0, sizeof(stats->snake_hits));
-    memset(stats->ladder_hits, 0, sizeof(stats->ladder_hits));
-    stats->total_games = 0;
+    free(stats->snake_hits);
+    free(stats->ladder_hits);
+    memset(stats, 0, sizeof(*stats));
 }
 
 /**
@@ -28,34 +54,33 @@ void stats_update(const Board* board, const GameResult* result, Stats* stats) {
     if (!board || !result || !stats || !result->won) return;
 
     int position = 1;
+    int streak = 0;  // Highest-face rolls in a row, across turns like the game kernel (see rules.h)
 
     for (int i = 0; i < result->move_count; i++) {
         int roll = result->moves[i];
-        int next = position + roll;
 
-        // If the move overshoots the board, ignore it
-        if (next > board->size) {
-            next = position;
+        if (board->rules & RULE_THREE_MAX_HOME) {
+            streak = (roll == result->die_faces) ? streak + 1 : 0;
+            if (streak == RULE_MAX_STREAK) {
+                position = 1;
+                streak = 0;
+                continue;
+            }
         }
 
+        // Apply the board's overshoot rule
+        int next = rules_target(board->rules, board->size, position, roll);
+
         // Check if there's a jump (snake or ladder)
         int jumped = board_apply_jump(board, next);
 
         if (jumped != next) {
-            // Determine if it was a snake
-            for (int j = 0; j < board->num_snakes; j++) {
-                if (board->snakes[j].start == next && board->snakes[j].end == jumped) {
-                    stats->snake_hits[j]++;
-                    break;
-                }
-            }
-
-            // Determine if it was a ladder
-            for (int j = 0; j < board->num_ladders; j++) {
-                if (board->ladders[j].start == next && board->ladders[j].end == jumped) {
-                    stats->ladder_hits[j]++;
-                    break;
-                }
+            // The jump starting on `next` is snakes[slot] or ladders[slot]
+            int slot = board->jump_slot[next];
+            if (jumped < next) {
+                if (slot < stats->num_snakes) stats->snake_hits[slot]++;
+            } else {
+                if (slot < stats->num_ladders) stats->ladder_hits[slot]++;
             }
 
             position = jumped;
@@ -67,6 +92,24 @@ void stats_update(const Board* board, const GameResult* result, Stats* stats) {
     stats->total_games++;
 }
 
+/**
+ * Adds all counters of `from` to `into`.
+ *
+ * @param into Pointer to the Stats structure that receives the counts.
+ * @param from Pointer to the Stats structure to add.
+ */
+void stats_merge(Stats* into, const Stats* from) {
+    if (!into || !from) return;
+
+    for (int i = 0; i < into->num_snakes && i < from->num_snakes; i++) {
+        into->snake_hits[i] += from->snake_hits[i];
+    }
+    for (int i = 0; i < into->num_ladders && i < from->num_ladders; i++) {
+        into->ladder_hits[i] += from->ladder_hits[i];
+    }
+    into->total_games += from->total_games;
+}
+
 /**
  * Prints out statistics about how often each snake and ladder was used.
  *
@@ -76,21 +119,31 @@ void stats_update(const Board* board, const GameResult* result, Stats* stats) {
 void stats_print(const Board* board, const Stats* stats) {
     if (!board || !stats) return;
 
-    printf("\n📊 Snake and Ladder Usage Statistics (across %d games):\n", stats->total_games);
+    printf("\n📊 Snake and Ladder Usage Statistics (across %llu games):\n",
+           (unsigned long long)stats->total_games);
+
+    int snakes = board->num_snakes < stats->num_snakes ? board->num_snakes : stats->num_snakes;
+    int ladders = board->num_ladders < stats->num_ladders ? board->num_ladders : stats->num_ladders;
 
     printf("\n🐍 Snakes:\n");
-    for (int i = 0; i < board->num_snakes; i++) {
-        int count = stats->snake_hits[i];
+    for (int i = 0; i < snakes && i < BOARD_PRINT_LIMIT; i++) {
+        uint64_t count = stats->snake_hits[i];
         double freq = (stats->total_games > 0) ? ((double)count / stats->total_games) : 0.0;
-        printf("  Snake %2d: from %3d to %3d — used %4d times (%.2f per game)\n",
-               i + 1, board->snakes[i].start, board->snakes[i].end, count, freq);
+        printf("  Snake %2d: from %3d to %3d — used %4llu times (%.2f per game)\n",
+               i + 1, board->snakes[i].start, board->snakes[i].end, (unsigned long long)count, freq);
+    }
+    if (snakes > BOARD_PRINT_LIMIT) {
+        printf("  ... (%d more)\n", snakes - BOARD_PRINT_LIMIT);
     }
 
     printf("\n🪜 Ladders:\n");
-    for (int i = 0; i < board->num_ladders; i++) {
-        int count = stats->ladder_hits[i];
+    for (int i = 0; i < ladders && i < BOARD_PRINT_LIMIT; i++) {
+        uint64_t count = stats->ladder_hits[i];
         double freq = (stats->total_games > 0) ? ((double)count / stats->total_games) : 0.0;
-        printf("  Ladder %2d: from %3d to %3d — used %4d times (%.2f per game)\n",
-               i + 1, board->ladders[i].start, board->ladders[i].end, count, freq);
+        printf("  Ladder %2d: from %3d to %3d — used %4llu times (%.2f per game)\n",
+               i + 1, board->ladders[i].start, board->ladders[i].end, (unsigned long long)count, freq);
+    }
+    if (ladders > BOARD_PRINT_LIMIT) {
+        printf("  ... (%d more)\n", ladders - BOARD_PRINT_LIMIT);
     }
 }
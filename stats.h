@@ -2,22 +2,36 @@
 
 #include "board.h"
 #include "simulator.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 /**
  * Structure to track statistics of snake and ladder usage during simulations.
  */
 typedef struct {
-    int snake_hits[MAX_SNAKES];     // Number of times each snake was encountered
-    int ladder_hits[MAX_LADDERS];   // Number of times each ladder was used
-    int total_games;                // Total number of games simulated
+    uint64_t* snake_hits;   // Number of times each snake was encountered
+    int num_snakes;
+    uint64_t* ladder_hits;  // Number of times each ladder was used
+    int num_ladders;
+    uint64_t total_games;   // Total number of games simulated
 } Stats;
 
 /**
- * Initializes the statistics structure by resetting all counters.
+ * Initializes the statistics structure with one zeroed counter per snake
+ * and ladder of the board. Release it with stats_free().
  *
  * @param stats Pointer to the Stats structure to initialize.
+ * @param board Pointer to the board whose jumps are counted.
+ * @return true on success, false on invalid parameters or allocation failure.
  */
-void stats_init(Stats* stats);
+bool stats_init(Stats* stats, const Board* board);
+
+/**
+ * Releases the counters of a Stats structure. Safe to call on a zeroed structure.
+ *
+ * @param stats Pointer to the Stats structure.
+ */
+void stats_free(Stats* stats);
 
 /**
  * Updates the statistics with the results from a completed game.
@@ -30,9 +44,20 @@ void stats_init(Stats* stats);
  */
 void stats_update(const Board* board, const GameResult* result, Stats* stats);
 
+/**
+ * Adds the counters of one Stats structure to another,
+ * e.g. to combine statistics collected on several threads.
+ * Both must have been initialized for the same board.
+ *
+ * @param into Pointer to the Stats structure that receives the counts.
+ * @param from Pointer to the Stats structure to add.
+ */
+void stats_merge(Stats* into, const Stats* from);
+
 /**
  * Prints the collected statistics for all snakes and ladders,
  * including how often each was used and their average usage per game.
+ * At most BOARD_PRINT_LIMIT snakes and ladders are listed.
  *
  * @param board Pointer to the board structure.
  * @param stats Pointer to the Stats structure containing usage statistics.
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <time.h>
+
+/**
+ * Seconds elapsed from `from` to `to`.
+ */
+static inline double timing_seconds_between(const struct timespec* from, const struct timespec* to) {
+    return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+/**
+ * Seconds elapsed since `from`, on CLOCK_MONOTONIC.
+ * Callers define _POSIX_C_SOURCE for clock_gettime() before any include.
+ */
+static inline double timing_seconds_since(const struct timespec* from) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timing_seconds_between(from, &now);
+}